@@ -0,0 +1,431 @@
+/**
+ * \file            bench.c
+ * \brief           Keystroke throughput and render cost benchmark
+ *
+ * Synthetic workloads are fed to \ref microrl_processing_input key by key, like they
+ * come from terminal. Output callback only counts calls and bytes, so the numbers of
+ * output don't depend on the host and only time is measured. Command line length is
+ * set at build time, Makefile builds the benchmark for several lengths.
+ *
+ * With BENCH_SINGLE set to 1 the library is compiled in this file from single header
+ * microrl_single.h and writes output by direct call of output callback, so the gain of
+ * inlining across the library boundary is measured against the library build.
+ *
+ * The first iteration of every workload is also drawn by VT100 screen model, then the row
+ * with cursor must show prompt, command line and suggestion, and cursor must be at its position
+ * in command line. So output-reducing changes are checked to keep the screen right.
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#define _GNU_SOURCE                                 /* sched_setaffinity() */
+
+#ifndef BENCH_SINGLE
+#define BENCH_SINGLE                        0
+#endif
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if BENCH_SINGLE
+#include "microrl_single.h"
+#else
+#include "microrl.h"
+#endif /* BENCH_SINGLE */
+#include "vt100.h"
+
+#define BENCH_LINE_LEN                      (MICRORL_CFG_CMDLINE_LEN - 1)   /* The longest line that fits */
+#define BENCH_HIST_LINES                    16
+#define BENCH_PASTE_LEN                     65536
+#define BENCH_TABLE_MAX                     10000
+#define BENCH_SCREEN_ROWS                   1024    /* Completion prints up to 1000 rows and returns cursor above them */
+#define BENCH_SCREEN_COLS                   (MICRORL_CFG_CMDLINE_LEN + MICRORL_CFG_TERMINAL_WIDTH)    /* Nothing wraps */
+#define BENCH_BATCH_NS                      1000000 /* Batch is long enough for timer not to dominate */
+#define BENCH_BATCH_MAX                     4096
+
+/**
+ * \brief           Workload
+ */
+typedef struct {
+    const char* name_str;                       /*!< Name printed in report */
+    void (*setup_fn)(microrl_t* mrl);           /*!< Optional preparation, not measured */
+    void (*run_fn)(microrl_t* mrl);             /*!< One measured iteration, must leave the same state */
+    size_t table_len;                           /*!< Number of completion candidates */
+} bench_workload_t;
+
+static uint64_t out_calls;
+static uint64_t out_bytes;
+static uint64_t key_cnt;
+static uint64_t in_bytes;
+
+static char name_buf[BENCH_TABLE_MAX][8];
+static const char* name_table[BENCH_TABLE_MAX];
+static char prefix_str[8];
+static char paste_buf[BENCH_PASTE_LEN];
+static size_t paste_len;
+static vt100_t screen;
+static uint8_t screen_on;
+static double batch_arr[BENCH_BATCH_MAX];
+
+/**
+ * \brief           Get monotonic time
+ * \return          Time in nanoseconds
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief           Output callback, counts output instead of printing it
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       str: Output string
+ * \return          Number of characters
+ */
+static int bench_print(microrl_t* mrl, const char* str) {
+    size_t len = strlen(str);
+
+    (void)mrl;
+    ++out_calls;
+    out_bytes += len;
+    if (screen_on) {
+        vt100_write(&screen, str, len);
+    }
+    return (int)len;
+}
+
+#if BENCH_SINGLE
+/* Library is compiled here and calls the output callback directly */
+#define MICRORL_CFG_OUT_FN(mrl, str)        bench_print((mrl), (str))
+#define MICRORL_IMPLEMENTATION
+#include "microrl_single.h"
+#endif /* BENCH_SINGLE */
+
+/**
+ * \brief           Execute callback, does nothing
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          '0'
+ */
+static int bench_execute(microrl_t* mrl, int argc, const char* const *argv) {
+    (void)mrl;
+    (void)argc;
+    (void)argv;
+    return 0;
+}
+
+/**
+ * \brief           Feed input of keys
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       data_ptr: Input
+ * \param[in]       len: Length of input
+ * \param[in]       keys: Number of keys the input is produced by
+ */
+static void feed(microrl_t* mrl, const char* data_ptr, size_t len, size_t keys) {
+    microrl_processing_input(mrl, data_ptr, len);
+    key_cnt += keys;
+    in_bytes += len;
+}
+
+/**
+ * \brief           Type string key by key
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       str: String to type
+ */
+static void type(microrl_t* mrl, const char* str) {
+    for (; *str != '\0'; ++str) {
+        feed(mrl, str, 1, 1);
+    }
+}
+
+/**
+ * \brief           Type word of letters key by key
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       len: Length of word
+ */
+static void type_word(microrl_t* mrl, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        char ch = (char)('a' + i % 26);
+        feed(mrl, &ch, 1, 1);
+    }
+}
+
+/**
+ * \brief           Type the longest line and clear it
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void run_type(microrl_t* mrl) {
+    type_word(mrl, BENCH_LINE_LEN);
+    feed(mrl, "\025", 1, 1);                    /* Ctrl+U */
+}
+
+/**
+ * \brief           Type and enter a typical command
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void run_enter(microrl_t* mrl) {
+    type(mrl, "show interface eth0 counters\r");
+}
+
+/**
+ * \brief           Type the longest line but one and move cursor to the middle
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void setup_edit_mid(microrl_t* mrl) {
+    type_word(mrl, BENCH_LINE_LEN - 1);
+    feed(mrl, "\001", 1, 1);                    /* Ctrl+A */
+    for (size_t i = 0; i < BENCH_LINE_LEN / 2; ++i) {
+        feed(mrl, "\033[C", 3, 1);
+    }
+}
+
+/**
+ * \brief           Insert and delete character in the middle of line, the rest of line is redrawn
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void run_edit_mid(microrl_t* mrl) {
+    feed(mrl, "x", 1, 1);
+    feed(mrl, "\b", 1, 1);
+}
+
+/**
+ * \brief           Enter lines of half of the longest length
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void setup_hist(microrl_t* mrl) {
+    char str[16];
+
+    for (size_t i = 0; i < BENCH_HIST_LINES; ++i) {
+        snprintf(str, sizeof(str), "h%02u ", (unsigned)i);
+        type(mrl, str);
+        type_word(mrl, BENCH_LINE_LEN / 2 - strlen(str));
+        feed(mrl, "\r", 1, 1);
+    }
+}
+
+/**
+ * \brief           Scroll all history up and back down
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void run_hist(microrl_t* mrl) {
+    for (size_t i = 0; i < BENCH_HIST_LINES; ++i) {
+        feed(mrl, "\033[A", 3, 1);
+    }
+    for (size_t i = 0; i < BENCH_HIST_LINES; ++i) {
+        feed(mrl, "\033[B", 3, 1);
+    }
+}
+
+/**
+ * \brief           Complete on empty line, all candidates are printed
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void run_tab(microrl_t* mrl) {
+    feed(mrl, "\t", 1, 1);
+}
+
+/**
+ * \brief           Type prefix shared by 10 candidates in the middle of table
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void setup_tab_prefix(microrl_t* mrl) {
+    type(mrl, prefix_str);
+}
+
+/**
+ * \brief           Paste many lines at once
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void run_paste(microrl_t* mrl) {
+    feed(mrl, paste_buf, paste_len, paste_len);
+}
+
+static const bench_workload_t workload_arr[] = {
+    {"type",            NULL,               run_type,       0},
+    {"enter",           NULL,               run_enter,      0},
+    {"edit_mid",        setup_edit_mid,     run_edit_mid,   0},
+    {"hist_scroll",     setup_hist,         run_hist,       0},
+    {"tab_all_10",      NULL,               run_tab,        10},
+    {"tab_all_1k",      NULL,               run_tab,        1000},
+    {"tab_all_10k",     NULL,               run_tab,        10000},
+    {"tab_prefix_10",   setup_tab_prefix,   run_tab,        10},
+    {"tab_prefix_1k",   setup_tab_prefix,   run_tab,        1000},
+    {"tab_prefix_10k",  setup_tab_prefix,   run_tab,        10000},
+    {"paste_64k",       NULL,               run_paste,      0},
+};
+
+/**
+ * \brief           Check that screen shows command line of instance with cursor at its position
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \return          `1` if screen is right, `0` otherwise
+ */
+static int screen_check(const microrl_t* mrl) {
+    static char expect_str[BENCH_SCREEN_COLS + 1];
+    static char row_str[BENCH_SCREEN_COLS + 1];
+    size_t prompt_len = strlen(MICRORL_CFG_PROMPT_STRING);
+
+    snprintf(expect_str, sizeof(expect_str), "%s%.*s%.*s", MICRORL_CFG_PROMPT_STRING,
+             (int)mrl->cmdlen, mrl->cmdline_str, (int)mrl->hint_shown, mrl->hint_str + mrl->cmdlen);
+    for (size_t len = strlen(expect_str); len > 0 && expect_str[len - 1] == ' '; --len) {
+        expect_str[len - 1] = '\0';             /* Screen row has no trailing spaces */
+    }
+    vt100_get_row(&screen, screen.row, row_str, sizeof(row_str));
+
+    if (strcmp(row_str, expect_str) == 0 && screen.col == prompt_len + mrl->cursor) {
+        return 1;
+    }
+    fprintf(stderr, "screen:   \"%s\", cursor at %zu\nexpected: \"%s\", cursor at %zu\n",
+            row_str, screen.col, expect_str, prompt_len + (size_t)mrl->cursor);
+    return 0;
+}
+
+/**
+ * \brief           Compare times of batches for qsort()
+ * \param[in]       a: First time
+ * \param[in]       b: Second time
+ * \return          Negative, zero or positive value, if the first time is less, equal or greater
+ */
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief           Pin the benchmark to the CPU it is started on, so it isn't migrated between
+ *                      CPUs with different caches and clocks while it's measured
+ * \return          Number of CPU, or `-1` if it can't be pinned
+ */
+static int pin_cpu(void) {
+    cpu_set_t set;
+    int cpu = sched_getcpu();
+
+    if (cpu < 0) {
+        return -1;
+    }
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0 ? cpu : -1;
+}
+
+/**
+ * \brief           Prepare completion table and paste buffer
+ */
+static void bench_init(void) {
+    for (size_t i = 0; i < BENCH_TABLE_MAX; ++i) {  /* Names are zero-padded to be sorted */
+        snprintf(name_buf[i], sizeof(name_buf[i]), "c%05u", (unsigned)i);
+        name_table[i] = name_buf[i];
+    }
+
+    size_t line_len = BENCH_LINE_LEN / 2;
+    while (paste_len + line_len + 1 <= sizeof(paste_buf)) {
+        size_t len = (size_t)snprintf(paste_buf + paste_len, line_len + 1, "echo %u ", (unsigned)paste_len);
+        for (; len < line_len; ++len) {
+            paste_buf[paste_len + len] = (char)('a' + len % 26);
+        }
+        paste_buf[paste_len + len] = '\r';
+        paste_len += len + 1;
+    }
+}
+
+/**
+ * \brief           Program entry point
+ */
+int main(int argc, char** argv) {
+    double min_ms = (argc > 1) ? strtod(argv[1], NULL) : 200.0;
+    int res = 0;
+
+    if (vt100_init(&screen, BENCH_SCREEN_ROWS, BENCH_SCREEN_COLS) != 0) {
+        perror("vt100_init");
+        return 1;
+    }
+    bench_init();
+    int cpu = pin_cpu();
+    if (cpu < 0) {
+        perror("warning: can't pin to CPU");
+    }
+    printf("MICRORL_CFG_CMDLINE_LEN %u, %s build, CPU %d, every workload runs at least %.0f ms\n",
+           (unsigned)MICRORL_CFG_CMDLINE_LEN, BENCH_SINGLE ? "single header" : "library", cpu, min_ms);
+    printf("%-16s %9s %9s %10s %7s %10s %10s %10s %7s\n", "workload", "keys", "bytes", "ns/byte", "spread",
+           "calls/key", "bytes/key", "seqs/key", "screen");
+
+    for (size_t w = 0; w < MICRORL_ARRAYSIZE(workload_arr); ++w) {
+        const bench_workload_t* wl_ptr = &workload_arr[w];
+        microrl_t mrl;
+
+        vt100_reset(&screen);
+        screen_on = 1;
+        microrl_init(&mrl, bench_print, bench_execute);
+        if (wl_ptr->table_len != 0) {
+            microrl_set_complete_table(&mrl, name_table, wl_ptr->table_len);
+            snprintf(prefix_str, sizeof(prefix_str), "c%04u", (unsigned)(wl_ptr->table_len / 2 / 10));
+        }
+        if (wl_ptr->setup_fn != NULL) {
+            wl_ptr->setup_fn(&mrl);
+        }
+
+        /* The first iteration warms up caches, gives numbers of one iteration and is drawn on screen */
+        out_calls = out_bytes = key_cnt = in_bytes = 0;
+        memset(&screen.stats, 0x00, sizeof(screen.stats));
+        wl_ptr->run_fn(&mrl);
+        screen_on = 0;
+        uint64_t iter_keys = key_cnt;
+        uint64_t iter_bytes = in_bytes;
+        uint64_t iter_seqs = screen.stats.seqs;
+        int screen_ok = screen_check(&mrl) && screen.stats.unknown == 0;
+        if (!screen_ok) {
+            res = 1;
+        }
+
+        /*
+         * Time is measured in batches of iterations and the fastest batch is taken, so preemption
+         * and slow periods of host don't count. Spread is how much the median batch is slower
+         */
+        size_t batch_cnt = 0;
+        out_calls = out_bytes = key_cnt = in_bytes = 0;
+        uint64_t start_ns = now_ns();
+        do {
+            uint64_t batch_start_ns = now_ns();
+            uint64_t batch_bytes = in_bytes;
+            uint64_t batch_ns;
+            do {
+                wl_ptr->run_fn(&mrl);
+                batch_ns = now_ns() - batch_start_ns;
+            } while (batch_ns < BENCH_BATCH_NS);
+            batch_arr[batch_cnt++] = (double)batch_ns / (double)(in_bytes - batch_bytes);
+        } while ((batch_cnt < BENCH_BATCH_MAX) && ((double)(now_ns() - start_ns) < min_ms * 1e6));
+        qsort(batch_arr, batch_cnt, sizeof(batch_arr[0]), cmp_double);
+
+        printf("%-16s %9llu %9llu %10.2f %6.1f%% %10.2f %10.1f %10.2f %7s\n", wl_ptr->name_str,
+               (unsigned long long)iter_keys, (unsigned long long)iter_bytes, batch_arr[0],
+               (batch_arr[batch_cnt / 2] / batch_arr[0] - 1.0) * 100.0,
+               (double)out_calls / (double)key_cnt, (double)out_bytes / (double)key_cnt,
+               (double)iter_seqs / (double)iter_keys, screen_ok ? "ok" : "WRONG");
+    }
+    vt100_deinit(&screen);
+
+    return res;
+}
@@ -0,0 +1,84 @@
+#!/bin/sh
+#
+# Compare time per byte of two builds of the keystroke benchmark. Both binaries are run in turn
+# many times for a short time, so they see the same slow and fast periods of host, and the fastest
+# result of every workload is taken. Comparison is repeated in rounds and the change of every round
+# is printed too, a change within their spread is noise.
+#
+# Usage: bench_compare.sh [-n runs] [-r rounds] [-t ms] base new
+#   -n runs    runs of every binary in a round (10)
+#   -r rounds  number of rounds (3)
+#   -t ms      minimum time of every workload in a run (20)
+#   base new   benchmark binaries, e.g. bench/microrl_bench_255 bench/microrl_bench_single_255
+#
+# This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+#
+
+RUNS=10
+ROUNDS=3
+TIME=20
+while getopts "n:r:t:" opt; do
+    case $opt in
+        n) RUNS=$OPTARG ;;
+        r) ROUNDS=$OPTARG ;;
+        t) TIME=$OPTARG ;;
+        *) sed -n '8,12s/^# \{0,1\}//p' "$0" >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+if [ $# -ne 2 ]; then
+    sed -n '8,12s/^# \{0,1\}//p' "$0" >&2
+    exit 1
+fi
+BASE=$1
+NEW=$2
+
+OUT=$(mktemp "${TMPDIR:-/tmp}/microrl_compare.XXXXXX") || exit 1
+trap 'rm -f "$OUT"' EXIT
+
+echo "$BASE vs $NEW, best of $RUNS runs of $TIME ms in each of $ROUNDS rounds"
+round=1
+while [ $round -le "$ROUNDS" ]; do
+    run=1
+    while [ $run -le "$RUNS" ]; do
+        for bin in "$BASE" "$NEW"; do
+            if ! res=$("$bin" "$TIME"); then    # Wrong screen fails the comparison
+                echo "$res"
+                exit 1
+            fi
+            echo "$res" | awk -v bin="$bin" -v round=$round 'NR > 2 { print round, bin, $1, $4 }' >> "$OUT"
+        done
+        run=$((run + 1))
+    done
+    round=$((round + 1))
+done
+
+awk -v base="$BASE" -v rounds="$ROUNDS" '
+    {
+        key = $1 SUBSEP $2 SUBSEP $3
+        if (!(key in best) || $4 < best[key]) {
+            best[key] = $4
+        }
+        if (!(($2, $3) in all) || $4 < all[$2, $3]) {
+            all[$2, $3] = $4
+        }
+        if (!($3 in seen)) {
+            seen[$3] = 1
+            order[n++] = $3
+        }
+        if ($2 != base) {
+            new = $2
+        }
+    }
+    END {
+        printf "%-16s %12s %12s %8s  %s\n", "workload", "base ns/byte", "new ns/byte", "change", "change of rounds"
+        for (i = 0; i < n; ++i) {
+            w = order[i]
+            line = ""
+            for (r = 1; r <= rounds; ++r) {
+                line = line sprintf(" %+6.1f%%", (best[r, new, w] / best[r, base, w] - 1) * 100)
+            }
+            printf "%-16s %12.2f %12.2f %+7.1f%% %s\n", w, all[base, w], all[new, w],
+                (all[new, w] / all[base, w] - 1) * 100, line
+        }
+    }' "$OUT"
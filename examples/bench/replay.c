@@ -0,0 +1,749 @@
+/**
+ * \file            replay.c
+ * \brief           Record and replay of session transcripts to catch output and speed regressions
+ *
+ * Transcript is a text file with input chunks as they were received, with time in microseconds
+ * since start of session, each followed by output it caused:
+ *
+ *      config CMDLINE_LEN=255 ...
+ *      o "> "
+ *      i 0 "h"
+ *      o "h"
+ *      i 120 "\r"
+ *      o "\r\n[h]\r\n> "
+ *
+ * Strings are C-like: `\\`, `\"`, `\r`, `\n`, `\t`, `\e` and `\xHH` escapes, other bytes as is.
+ * Output before the first input is printed on initialization. `config` line tells the configuration
+ * transcript is recorded with, transcripts of other configurations are skipped. Transcript without
+ * output lines is only timed, its output is written by update mode.
+ *
+ * Replay feeds every chunk to \ref microrl_processing_input at once and compares output with the
+ * recorded one, then replays the whole session again and again to measure time per input byte.
+ * Output bytes and time are compared with baseline saved before, so both regressions are reported.
+ * Execute callback prints the tokens of command, so output doesn't depend on the host.
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "microrl.h"
+
+#define REPLAY_STR_(x)                      #x
+#define REPLAY_STR(x)                       REPLAY_STR_(x)
+#define REPLAY_LINE_LEN_MAX                 (1024 * 1024)   /* The longest line of transcript */
+#define REPLAY_SNIPPET_LEN                  40              /* Output shown around mismatch */
+
+/* Settings changing output, transcripts are replayed only with the same ones */
+static const char config_str[] =
+    "CMDLINE_LEN=" REPLAY_STR(MICRORL_CFG_CMDLINE_LEN)
+    " TOKENS=" REPLAY_STR(MICRORL_CFG_CMD_TOKEN_NMB)
+    " ESC_SEQ=" REPLAY_STR(MICRORL_CFG_USE_ESC_SEQ)
+    " CR=" REPLAY_STR(MICRORL_CFG_USE_CARRIAGE_RETURN)
+    " PROMPT_COLOR=" REPLAY_STR(MICRORL_CFG_USE_PROMPT_COLOR)
+    " HISTORY=" REPLAY_STR(MICRORL_CFG_USE_HISTORY) "/" REPLAY_STR(MICRORL_CFG_RING_HISTORY_LEN)
+    " HINTS=" REPLAY_STR(MICRORL_CFG_USE_HISTORY_HINTS)
+    " COMPLETE=" REPLAY_STR(MICRORL_CFG_USE_COMPLETE)
+    " TABLE=" REPLAY_STR(MICRORL_CFG_USE_COMPLETE_TABLE)
+    " CYCLE=" REPLAY_STR(MICRORL_CFG_USE_COMPLETE_CYCLE)
+    " FUZZY=" REPLAY_STR(MICRORL_CFG_USE_COMPLETE_FUZZY)
+    " WIDTH=" REPLAY_STR(MICRORL_CFG_TERMINAL_WIDTH)
+    " QUERY=" REPLAY_STR(MICRORL_CFG_COMPL_QUERY_ITEMS)
+    " QUOTING=" REPLAY_STR(MICRORL_CFG_USE_QUOTING)
+    " ECHO_OFF=" REPLAY_STR(MICRORL_CFG_USE_ECHO_OFF)
+    " CTRL_C=" REPLAY_STR(MICRORL_CFG_USE_CTRL_C);
+
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE
+/* Sorted table of commands to complete */
+static const char* const cmd_table[] = {"clear", "exit", "help", "history", "list", "show", "status", "version"};
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE */
+
+/**
+ * \brief           Input chunk and output it caused
+ */
+typedef struct {
+    uint64_t time_us;                           /*!< Time of input since start of session */
+    char* in_ptr;                               /*!< Input, NULL for output printed on initialization */
+    size_t in_len;                              /*!< Length of input */
+    char* out_ptr;                              /*!< Output */
+    size_t out_len;                             /*!< Length of output */
+} replay_chunk_t;
+
+/**
+ * \brief           Session transcript
+ */
+typedef struct {
+    char config_str[512];                       /*!< Configuration transcript is recorded with */
+    replay_chunk_t* chunk_arr;                  /*!< Chunks, the first one is initialization */
+    size_t chunk_cnt;                           /*!< Number of chunks */
+    size_t chunk_max;                           /*!< Allocated number of chunks */
+    uint8_t has_out;                            /*!< Transcript has output to compare */
+} replay_transcript_t;
+
+/**
+ * \brief           Growing byte buffer
+ */
+typedef struct {
+    char* buf;                                  /*!< Data */
+    size_t len;                                 /*!< Length of data */
+    size_t size;                                /*!< Allocated size */
+} replay_buf_t;
+
+static replay_buf_t out_buf;                    /* Output captured while it's compared or recorded */
+static uint8_t out_capture;
+static uint8_t out_echo;                        /* Output is printed to terminal while recording */
+static uint64_t out_bytes;
+static uint8_t exit_flag;
+
+/**
+ * \brief           Get monotonic time
+ * \return          Time in nanoseconds
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief           Append data to buffer
+ * \param[in,out]   buf_ptr: Buffer
+ * \param[in]       data_ptr: Data
+ * \param[in]       len: Length of data
+ */
+static void buf_append(replay_buf_t* buf_ptr, const char* data_ptr, size_t len) {
+    if (buf_ptr->len + len > buf_ptr->size) {
+        size_t size = buf_ptr->size ? buf_ptr->size : 4096;
+        while (size < buf_ptr->len + len) {
+            size *= 2;
+        }
+        buf_ptr->buf = realloc(buf_ptr->buf, size);
+        if (buf_ptr->buf == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+        buf_ptr->size = size;
+    }
+    memcpy(buf_ptr->buf + buf_ptr->len, data_ptr, len);
+    buf_ptr->len += len;
+}
+
+/**
+ * \brief           Copy data to allocated memory
+ * \param[in]       data_ptr: Data
+ * \param[in]       len: Length of data
+ * \return          Copy of data
+ */
+static char* mem_dup(const char* data_ptr, size_t len) {
+    char* ptr = malloc(len ? len : 1);
+
+    if (ptr == NULL) {
+        perror("malloc");
+        exit(1);
+    }
+    memcpy(ptr, data_ptr, len);
+    return ptr;
+}
+
+/**
+ * \brief           Output callback, counts output and captures it if it's needed
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       str: Output string
+ * \return          Number of characters
+ */
+static int replay_print(microrl_t* mrl, const char* str) {
+    size_t len = strlen(str);
+
+    (void)mrl;
+    out_bytes += len;
+    if (out_capture) {
+        buf_append(&out_buf, str, len);
+    }
+    if (out_echo) {
+        fwrite(str, 1, len, stdout);
+        fflush(stdout);
+    }
+    return (int)len;
+}
+
+/**
+ * \brief           Execute callback, prints tokens of command. Command `exit` finishes recording
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          '0'
+ */
+static int replay_execute(microrl_t* mrl, int argc, const char* const *argv) {
+    for (int i = 0; i < argc; ++i) {
+        replay_print(mrl, "[");
+        replay_print(mrl, argv[i]);
+        replay_print(mrl, "]");
+    }
+    replay_print(mrl, MICRORL_CFG_END_LINE);
+    if (strcmp(argv[0], "exit") == 0) {
+        exit_flag = 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Initialize instance for session
+ * \param[out]      mrl: \ref microrl_t working instance
+ */
+static void session_init(microrl_t* mrl) {
+    microrl_init(mrl, replay_print, replay_execute);
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE
+    microrl_set_complete_table(mrl, cmd_table, MICRORL_ARRAYSIZE(cmd_table));
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE */
+}
+
+/**
+ * \brief           Add chunk to transcript
+ * \param[in,out]   trn: Transcript
+ * \return          New chunk
+ */
+static replay_chunk_t* transcript_add(replay_transcript_t* trn) {
+    if (trn->chunk_cnt == trn->chunk_max) {
+        trn->chunk_max = trn->chunk_max ? trn->chunk_max * 2 : 64;
+        trn->chunk_arr = realloc(trn->chunk_arr, trn->chunk_max * sizeof(replay_chunk_t));
+        if (trn->chunk_arr == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memset(&trn->chunk_arr[trn->chunk_cnt], 0x00, sizeof(replay_chunk_t));
+    return &trn->chunk_arr[trn->chunk_cnt++];
+}
+
+/**
+ * \brief           Free transcript
+ * \param[in,out]   trn: Transcript
+ */
+static void transcript_free(replay_transcript_t* trn) {
+    for (size_t i = 0; i < trn->chunk_cnt; ++i) {
+        free(trn->chunk_arr[i].in_ptr);
+        free(trn->chunk_arr[i].out_ptr);
+    }
+    free(trn->chunk_arr);
+    memset(trn, 0x00, sizeof(replay_transcript_t));
+}
+
+/**
+ * \brief           Decode quoted string of transcript
+ * \param[in]       str: Quoted string
+ * \param[out]      buf_ptr: Buffer to append decoded bytes to
+ * \return          `0` on success, `-1` on syntax error
+ */
+static int str_decode(const char* str, replay_buf_t* buf_ptr) {
+    if (*str++ != '"') {
+        return -1;
+    }
+    for (; *str != '"'; ++str) {
+        char ch = *str;
+
+        if (ch == '\0') {
+            return -1;
+        }
+        if (ch == '\\') {
+            switch (*++str) {
+                case 'r': ch = '\r'; break;
+                case 'n': ch = '\n'; break;
+                case 't': ch = '\t'; break;
+                case 'e': ch = '\033'; break;
+                case '\\': ch = '\\'; break;
+                case '"': ch = '"'; break;
+                case 'x': {
+                    char hex_str[3] = {str[1], str[1] ? str[2] : '\0', '\0'};
+                    char* end_ptr;
+                    ch = (char)strtoul(hex_str, &end_ptr, 16);
+                    if (end_ptr != hex_str + 2) {
+                        return -1;
+                    }
+                    str += 2;
+                    break;
+                }
+                default:
+                    return -1;
+            }
+        }
+        buf_append(buf_ptr, &ch, 1);
+    }
+    return 0;
+}
+
+/**
+ * \brief           Write bytes as quoted string of transcript
+ * \param[in]       file: Stream to write to
+ * \param[in]       data_ptr: Bytes
+ * \param[in]       len: Number of bytes
+ */
+static void str_encode(FILE* file, const char* data_ptr, size_t len) {
+    fputc('"', file);
+    for (size_t i = 0; i < len; ++i) {
+        unsigned char ch = (unsigned char)data_ptr[i];
+
+        switch (ch) {
+            case '\r': fputs("\\r", file); break;
+            case '\n': fputs("\\n", file); break;
+            case '\t': fputs("\\t", file); break;
+            case '\033': fputs("\\e", file); break;
+            case '\\': fputs("\\\\", file); break;
+            case '"': fputs("\\\"", file); break;
+            default:
+                if (ch < 0x20 || ch >= 0x7F) {
+                    fprintf(file, "\\x%02X", ch);
+                } else {
+                    fputc(ch, file);
+                }
+                break;
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * \brief           Read transcript file
+ * \param[in]       path: File name
+ * \param[out]      trn: Transcript
+ * \return          `0` on success, `-1` otherwise
+ */
+static int transcript_read(const char* path, replay_transcript_t* trn) {
+    static char line_str[REPLAY_LINE_LEN_MAX];
+    FILE* file = fopen(path, "r");
+    replay_buf_t data = {0};
+    size_t line_num = 0;
+    int res = 0;
+
+    memset(trn, 0x00, sizeof(replay_transcript_t));
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+    transcript_add(trn);                        /* Initialization */
+
+    while (res == 0 && fgets(line_str, sizeof(line_str), file) != NULL) {
+        replay_chunk_t* chunk_ptr = &trn->chunk_arr[trn->chunk_cnt - 1];
+        char* str = line_str;
+
+        ++line_num;
+        line_str[strcspn(line_str, "\r\n")] = '\0';
+        data.len = 0;
+        if (*str == '#' || *str == '\0') {
+            continue;
+        }
+        if (strncmp(str, "config ", 7) == 0) {
+            size_t len = strlen(str + 7);
+
+            len = len < sizeof(trn->config_str) ? len : (sizeof(trn->config_str) - 1);
+            memcpy(trn->config_str, str + 7, len);
+            trn->config_str[len] = '\0';
+        } else if (str[0] == 'i' && str[1] == ' ') {
+            char* end_ptr;
+            uint64_t time_us = strtoull(str + 2, &end_ptr, 10);
+
+            if (end_ptr == str + 2 || *end_ptr != ' ' || str_decode(end_ptr + 1, &data) != 0) {
+                res = -1;
+                break;
+            }
+            chunk_ptr = transcript_add(trn);
+            chunk_ptr->time_us = time_us;
+            chunk_ptr->in_ptr = mem_dup(data.buf, data.len);
+            chunk_ptr->in_len = data.len;
+        } else if (str[0] == 'o' && str[1] == ' ') {
+            if (str_decode(str + 2, &data) != 0) {
+                res = -1;
+                break;
+            }
+            chunk_ptr->out_ptr = realloc(chunk_ptr->out_ptr, chunk_ptr->out_len + data.len + 1);
+            memcpy(chunk_ptr->out_ptr + chunk_ptr->out_len, data.buf, data.len);
+            chunk_ptr->out_len += data.len;
+            trn->has_out = 1;
+        } else {
+            res = -1;
+        }
+    }
+    if (res != 0) {
+        fprintf(stderr, "%s:%zu: syntax error\n", path, line_num);
+        transcript_free(trn);
+    }
+    free(data.buf);
+    fclose(file);
+
+    return res;
+}
+
+/**
+ * \brief           Write transcript file
+ * \param[in]       path: File name
+ * \param[in]       trn: Transcript
+ * \return          `0` on success, `-1` otherwise
+ */
+static int transcript_write(const char* path, const replay_transcript_t* trn) {
+    FILE* file = fopen(path, "w");
+
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+    fprintf(file, "# MicroRL session transcript: \"i <us> <input>\" chunk is passed to microrl_processing_input(),\n"
+                  "# \"o <output>\" lines after it are output it causes\n");
+    fprintf(file, "config %s\n", trn->config_str);
+    for (size_t i = 0; i < trn->chunk_cnt; ++i) {
+        const replay_chunk_t* chunk_ptr = &trn->chunk_arr[i];
+
+        if (chunk_ptr->in_ptr != NULL) {
+            fprintf(file, "i %llu ", (unsigned long long)chunk_ptr->time_us);
+            str_encode(file, chunk_ptr->in_ptr, chunk_ptr->in_len);
+            fputc('\n', file);
+        }
+        if (chunk_ptr->out_len != 0) {
+            fputs("o ", file);
+            str_encode(file, chunk_ptr->out_ptr, chunk_ptr->out_len);
+            fputc('\n', file);
+        }
+    }
+
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+/**
+ * \brief           Record session typed in terminal or passed through pipe.
+ *                      Recording is finished by `exit` command or end of input
+ * \param[in]       path: Transcript file name
+ * \param[in]       read_len: Number of bytes to read at once from pipe
+ * \return          `0` on success, `-1` otherwise
+ */
+static int record(const char* path, size_t read_len) {
+    replay_transcript_t trn = {0};
+    struct termios old_tio, raw_tio;
+    uint8_t is_tty = isatty(STDIN_FILENO);
+    uint64_t start_ns;
+    microrl_t mrl;
+    char buf[256];
+
+    if (is_tty) {
+        tcgetattr(STDIN_FILENO, &old_tio);
+        raw_tio = old_tio;
+        raw_tio.c_lflag &= ~(ICANON | ECHO | ISIG);   /* Ctrl+C is recorded too */
+        raw_tio.c_iflag &= ~(ICRNL | IXON);
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw_tio);
+        read_len = sizeof(buf);                 /* Chunks are as terminal passes them */
+    } else if (read_len == 0 || read_len > sizeof(buf)) {
+        read_len = 1;
+    }
+
+    snprintf(trn.config_str, sizeof(trn.config_str), "%s", config_str);
+    out_capture = 1;
+    out_echo = is_tty;
+    out_buf.len = 0;
+    start_ns = now_ns();
+    session_init(&mrl);
+    replay_chunk_t* chunk_ptr = transcript_add(&trn);
+    chunk_ptr->out_ptr = mem_dup(out_buf.buf, out_buf.len);
+    chunk_ptr->out_len = out_buf.len;
+
+    while (!exit_flag) {
+        ssize_t len = read(STDIN_FILENO, buf, read_len);
+        if (len <= 0) {
+            break;
+        }
+
+        chunk_ptr = transcript_add(&trn);
+        chunk_ptr->time_us = (now_ns() - start_ns) / 1000;
+        chunk_ptr->in_ptr = mem_dup(buf, (size_t)len);
+        chunk_ptr->in_len = (size_t)len;
+        out_buf.len = 0;
+        microrl_processing_input(&mrl, buf, (size_t)len);
+        chunk_ptr->out_ptr = mem_dup(out_buf.buf, out_buf.len);
+        chunk_ptr->out_len = out_buf.len;
+    }
+
+    if (is_tty) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &old_tio);
+    }
+    out_capture = out_echo = 0;
+    int res = transcript_write(path, &trn);
+    if (res == 0) {
+        fprintf(stderr, "%zu chunks recorded to %s\n", trn.chunk_cnt - 1, path);
+    }
+    transcript_free(&trn);
+
+    return res;
+}
+
+/**
+ * \brief           Print part of output around mismatch
+ * \param[in]       name_str: Name of output
+ * \param[in]       data_ptr: Output
+ * \param[in]       len: Length of output
+ * \param[in]       pos: Position of mismatch
+ */
+static void print_snippet(const char* name_str, const char* data_ptr, size_t len, size_t pos) {
+    size_t from = (pos > REPLAY_SNIPPET_LEN / 2) ? (pos - REPLAY_SNIPPET_LEN / 2) : 0;
+    size_t to = (from + REPLAY_SNIPPET_LEN < len) ? (from + REPLAY_SNIPPET_LEN) : len;
+
+    fprintf(stderr, "  %-9s ", name_str);
+    str_encode(stderr, data_ptr + from, to - from);
+    fputc('\n', stderr);
+}
+
+/**
+ * \brief           Replay session and compare output with recorded one
+ * \param[in]       path: Transcript file name
+ * \param[in,out]   trn: Transcript, output is replaced with the replayed one in update mode
+ * \param[in]       update: Replace recorded output
+ * \return          `0` if output matches, `-1` otherwise
+ */
+static int replay_check(const char* path, replay_transcript_t* trn, uint8_t update) {
+    microrl_t mrl;
+    int res = 0;
+
+    out_capture = 1;
+    exit_flag = 0;
+    for (size_t i = 0; i < trn->chunk_cnt; ++i) {
+        replay_chunk_t* chunk_ptr = &trn->chunk_arr[i];
+
+        out_buf.len = 0;
+        if (i == 0) {
+            session_init(&mrl);
+        } else {
+            microrl_processing_input(&mrl, chunk_ptr->in_ptr, chunk_ptr->in_len);
+        }
+
+        if (update) {
+            free(chunk_ptr->out_ptr);
+            chunk_ptr->out_ptr = mem_dup(out_buf.buf, out_buf.len);
+            chunk_ptr->out_len = out_buf.len;
+        } else if (trn->has_out && res == 0
+                   && ((out_buf.len != chunk_ptr->out_len)
+                       || ((out_buf.len != 0) && (memcmp(out_buf.buf, chunk_ptr->out_ptr, out_buf.len) != 0)))) {
+            size_t pos = 0;
+            while (pos < out_buf.len && pos < chunk_ptr->out_len && out_buf.buf[pos] == chunk_ptr->out_ptr[pos]) {
+                ++pos;
+            }
+            fprintf(stderr, "%s: output of chunk %zu at %llu us differs at byte %zu\n", path, i,
+                    (unsigned long long)chunk_ptr->time_us, pos);
+            print_snippet("recorded", chunk_ptr->out_ptr, chunk_ptr->out_len, pos);
+            print_snippet("replayed", out_buf.buf, out_buf.len, pos);
+            res = -1;
+        }
+    }
+    out_capture = 0;
+
+    return res;
+}
+
+/**
+ * \brief           Replay session many times and measure the fastest batch of replays.
+ *                      Batch is long enough for timer and scheduler not to dominate short sessions
+ * \param[in]       trn: Transcript
+ * \param[in]       min_ms: Minimum time of all replays
+ * \param[out]      bytes_ptr: Output bytes of one replay
+ * \return          Time of one replay of the fastest batch in nanoseconds
+ */
+static uint64_t replay_time(const replay_transcript_t* trn, double min_ms, uint64_t* bytes_ptr) {
+    uint64_t best_ns = UINT64_MAX;
+    uint64_t total_ns = 0;
+    size_t batch = 1;
+
+    for (size_t run = 0; run < 5 || (double)total_ns < min_ms * 1e6; ++run) {
+        uint64_t start_ns = now_ns();
+        for (size_t n = 0; n < batch; ++n) {
+            microrl_t mrl;
+
+            out_bytes = 0;
+            session_init(&mrl);
+            for (size_t i = 1; i < trn->chunk_cnt; ++i) {
+                microrl_processing_input(&mrl, trn->chunk_arr[i].in_ptr, trn->chunk_arr[i].in_len);
+            }
+        }
+        uint64_t run_ns = now_ns() - start_ns;
+
+        total_ns += run_ns;
+        if (run_ns < 1000000 && batch < (SIZE_MAX / 2)) {
+            batch *= 2;                         /* Batch is too short yet, measure it again */
+            run = 0;
+            best_ns = UINT64_MAX;
+        } else if (run_ns / batch < best_ns) {
+            best_ns = run_ns / batch;
+        }
+    }
+    *bytes_ptr = out_bytes;
+
+    return best_ns;
+}
+
+/**
+ * \brief           Find transcript in baseline file
+ * \param[in]       base_path: Baseline file name
+ * \param[in]       path: Transcript file name
+ * \param[out]      bytes_ptr: Output bytes
+ * \param[out]      ns_ptr: Time per input byte in nanoseconds
+ * \return          `1` if transcript is found, `0` otherwise
+ */
+static int baseline_find(const char* base_path, const char* path, uint64_t* bytes_ptr, double* ns_ptr) {
+    FILE* file = fopen(base_path, "r");
+    char line_str[1024];
+    char name_str[1024];
+    unsigned long long bytes;
+    int found = 0;
+
+    if (file == NULL) {
+        return 0;
+    }
+    while (!found && fgets(line_str, sizeof(line_str), file) != NULL) {
+        if (line_str[0] != '#' && sscanf(line_str, "%1023s %llu %lf", name_str, &bytes, ns_ptr) == 3
+                && strcmp(name_str, path) == 0) {
+            *bytes_ptr = bytes;
+            found = 1;
+        }
+    }
+    fclose(file);
+
+    return found;
+}
+
+/**
+ * \brief           Print usage
+ * \param[in]       name: Program name
+ */
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s -r file [-c bytes]\n"
+                    "       %s [-u] [-s baseline | -b baseline [-t percent]] [-m ms] file...\n"
+                    "  -r file  record session typed in terminal or passed through pipe, until 'exit' command\n"
+                    "  -c num   bytes read at once from pipe while recording (1)\n"
+                    "  -u       replace recorded output with the replayed one\n"
+                    "  -s file  save output bytes and time per input byte to baseline\n"
+                    "  -b file  compare output bytes and time per input byte with baseline\n"
+                    "  -t pct   allowed slowdown against baseline (25)\n"
+                    "  -m ms    minimum time of replays of every transcript (100)\n", name, name);
+}
+
+/**
+ * \brief           Program entry point
+ */
+int main(int argc, char** argv) {
+    const char* record_path = NULL;
+    const char* save_path = NULL;
+    const char* base_path = NULL;
+    FILE* save_file = NULL;
+    size_t read_len = 1;
+    double tolerance = 25.0;
+    double min_ms = 100.0;
+    uint8_t update = 0;
+    int res = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:c:us:b:t:m:h")) != -1) {
+        switch (opt) {
+            case 'r': record_path = optarg; break;
+            case 'c': read_len = strtoul(optarg, NULL, 0); break;
+            case 'u': update = 1; break;
+            case 's': save_path = optarg; break;
+            case 'b': base_path = optarg; break;
+            case 't': tolerance = strtod(optarg, NULL); break;
+            case 'm': min_ms = strtod(optarg, NULL); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (record_path != NULL) {
+        return record(record_path, read_len) == 0 ? 0 : 1;
+    }
+    if (optind == argc) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (save_path != NULL) {
+        save_file = fopen(save_path, "w");
+        if (save_file == NULL) {
+            perror(save_path);
+            return 1;
+        }
+        fprintf(save_file, "# transcript  output_bytes  ns_per_input_byte\n");
+    }
+
+    printf("config %s\n", config_str);
+    printf("%-32s %7s %9s %10s %10s  %s\n", "transcript", "chunks", "in bytes", "out bytes", "ns/byte", "result");
+    for (int i = optind; i < argc; ++i) {
+        const char* path = argv[i];
+        replay_transcript_t trn;
+        char result_str[128] = "ok";
+        uint64_t in_len = 0;
+        uint64_t bytes;
+        uint64_t base_bytes;
+        double base_ns;
+
+        if (transcript_read(path, &trn) != 0) {
+            res = 1;
+            continue;
+        }
+        if (strcmp(trn.config_str, config_str) != 0) {
+            printf("%-32s skipped, recorded with config %s\n", path, trn.config_str);
+            transcript_free(&trn);
+            continue;
+        }
+        for (size_t c = 1; c < trn.chunk_cnt; ++c) {
+            in_len += trn.chunk_arr[c].in_len;
+        }
+
+        fflush(stdout);
+        if (replay_check(path, &trn, update) != 0) {
+            snprintf(result_str, sizeof(result_str), "OUTPUT DIFFERS");
+            res = 1;
+        } else if (update && transcript_write(path, &trn) != 0) {
+            res = 1;
+        } else if (!trn.has_out && !update) {
+            snprintf(result_str, sizeof(result_str), "not checked, no output recorded");
+        }
+
+        double ns = (double)replay_time(&trn, min_ms, &bytes) / (double)(in_len ? in_len : 1);
+        if (base_path != NULL && baseline_find(base_path, path, &base_bytes, &base_ns)) {
+            if (bytes > base_bytes) {
+                snprintf(result_str + strlen(result_str), sizeof(result_str) - strlen(result_str),
+                         ", OUTPUT +%llu BYTES", (unsigned long long)(bytes - base_bytes));
+                res = 1;
+            }
+            if (ns > base_ns * (1.0 + tolerance / 100.0)) {
+                snprintf(result_str + strlen(result_str), sizeof(result_str) - strlen(result_str),
+                         ", SLOWER +%.0f%%", (ns / base_ns - 1.0) * 100.0);
+                res = 1;
+            }
+        }
+        if (save_file != NULL) {
+            fprintf(save_file, "%s %llu %.2f\n", path, (unsigned long long)bytes, ns);
+        }
+
+        printf("%-32s %7zu %9llu %10llu %10.2f  %s\n", path, trn.chunk_cnt - 1, (unsigned long long)in_len,
+               (unsigned long long)bytes, ns, result_str);
+        transcript_free(&trn);
+    }
+    if (save_file != NULL) {
+        fclose(save_file);
+    }
+    free(out_buf.buf);
+
+    return res;
+}
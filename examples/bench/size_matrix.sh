@@ -0,0 +1,141 @@
+#!/bin/sh
+#
+# Build microrl.c for host, ARM Cortex-M and AVR across a matrix of configurations and print
+# .text, .data and .bss of object, sizeof(microrl_t), worst-case stack of microrl_processing_input()
+# without callbacks (-fcallgraph-info, GCC 10 or newer) and the largest stack frame (-fstack-usage).
+# Toolchains not found in PATH are skipped.
+#
+# Usage: size_matrix.sh [-v] [-s config] [target...]
+#   -v         print worst-case call chain and stack usage of every function for every configuration
+#   -s config  print stack usage of every function for this configuration (full)
+#   target     host, arm or avr, all of them by default
+#
+# Extra compiler flags for all builds are taken from SIZE_CFLAGS.
+#
+# This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+#
+
+cd "$(dirname "$0")/../.." || exit 1
+
+SRC=src/microrl/microrl.c
+INC=src/include/microrl
+OUT=$(mktemp -d "${TMPDIR:-/tmp}/microrl_size.XXXXXX") || exit 1
+trap 'rm -rf "$OUT"' EXIT
+
+# Target name, compiler prefix and flags
+TARGETS="
+host||-O2
+arm|arm-none-eabi-|-Os -mcpu=cortex-m3 -mthumb
+avr|avr-|-Os -mmcu=atmega328p
+"
+
+# Configuration name and flags, every configuration starts from defaults of microrl_config.h
+CONFIGS="
+minimal|-DMICRORL_CFG_USE_PROMPT_COLOR=0 -DMICRORL_CFG_USE_HISTORY=0 -DMICRORL_CFG_USE_ESC_SEQ=0 -DMICRORL_CFG_USE_CARRIAGE_RETURN=0
+default|
+-prompt_color|-DMICRORL_CFG_USE_PROMPT_COLOR=0
+-history|-DMICRORL_CFG_USE_HISTORY=0
+-esc_seq|-DMICRORL_CFG_USE_ESC_SEQ=0
++complete|-DMICRORL_CFG_USE_COMPLETE=1
++complete_table|-DMICRORL_CFG_USE_COMPLETE=1 -DMICRORL_CFG_USE_COMPLETE_TABLE=1
++complete_cycle|-DMICRORL_CFG_USE_COMPLETE=1 -DMICRORL_CFG_USE_COMPLETE_CYCLE=1
++complete_fuzzy|-DMICRORL_CFG_USE_COMPLETE=1 -DMICRORL_CFG_USE_COMPLETE_TABLE=1 -DMICRORL_CFG_USE_COMPLETE_FUZZY=1
++quoting|-DMICRORL_CFG_USE_QUOTING=1
++echo_off|-DMICRORL_CFG_USE_ECHO_OFF=1
++history_front_coding|-DMICRORL_CFG_USE_HISTORY_FRONT_CODING=1
++history_hints|-DMICRORL_CFG_USE_HISTORY_HINTS=1
++libc_stdio|-DMICRORL_CFG_USE_LIBC_STDIO=1
++ctrl_c|-DMICRORL_CFG_USE_CTRL_C=1
++input_ring|-DMICRORL_CFG_USE_INPUT_RING=1
++async_print|-DMICRORL_CFG_USE_ASYNC_PRINT=1
++deferred_exec|-DMICRORL_CFG_USE_DEFERRED_EXEC=1
++events|-DMICRORL_CFG_USE_EVENTS=1
++stats|-DMICRORL_CFG_USE_STATS=1
++timing|-DMICRORL_CFG_USE_TIMING=1 -DMICRORL_CFG_TIMING_GET_TICK()=0
++shared_config|-DMICRORL_CFG_USE_SHARED_CONFIG=1
++command_hooks|-DMICRORL_CFG_USE_COMMAND_HOOKS=1
+full|-DMICRORL_CFG_USE_COMPLETE=1 -DMICRORL_CFG_USE_COMPLETE_TABLE=1 -DMICRORL_CFG_USE_COMPLETE_CYCLE=1 -DMICRORL_CFG_USE_COMPLETE_FUZZY=1 -DMICRORL_CFG_USE_QUOTING=1 -DMICRORL_CFG_USE_ECHO_OFF=1 -DMICRORL_CFG_USE_HISTORY_FRONT_CODING=1 -DMICRORL_CFG_USE_HISTORY_HINTS=1 -DMICRORL_CFG_USE_LIBC_STDIO=1 -DMICRORL_CFG_USE_CTRL_C=1 -DMICRORL_CFG_USE_INPUT_RING=1 -DMICRORL_CFG_USE_ASYNC_PRINT=1 -DMICRORL_CFG_USE_EVENTS=1 -DMICRORL_CFG_USE_STATS=1 -DMICRORL_CFG_USE_TIMING=1 -DMICRORL_CFG_TIMING_GET_TICK()=0 -DMICRORL_CFG_USE_COMMAND_HOOKS=1
+"
+
+VERBOSE=0
+STACK_CONFIG=full
+while getopts "vs:" opt; do
+    case $opt in
+        v) VERBOSE=1 ;;
+        s) STACK_CONFIG=$OPTARG ;;
+        *) sed -n '7,12s/^# \{0,1\}//p' "$0" >&2; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+SELECTED=${*:-host arm avr}
+
+# sizeof(microrl_t) is read from the size of symbol, so it works for cross compilers too
+printf '#include "microrl.h"\nchar microrl_sizeof[sizeof(microrl_t)];\n' > "$OUT/sizeof.c"
+
+# Print stack usage of functions from .su file, the largest first
+print_stack() {
+    sort -t "$(printf '\t')" -k2,2nr "$1" | awk -F '\t' '{ n = split($1, a, ":"); printf "    %6d  %-8s %s\n", $2, $3, a[n] }'
+}
+
+res=0
+printf "%-6s %-22s %7s %6s %6s %7s %6s %6s  %s\n" target config .text .data .bss sizeof input frame "largest frame"
+echo "$TARGETS" | while IFS='|' read -r target prefix tflags; do
+    [ -n "$target" ] || continue
+    case " $SELECTED " in *" $target "*) ;; *) continue ;; esac
+    cc=${prefix}gcc
+    if ! command -v "$cc" > /dev/null 2>&1; then
+        printf "%-6s %s not found, skipped\n" "$target" "$cc"
+        continue
+    fi
+    ciflags=
+    echo "int main(void) { return 0; }" > "$OUT/probe.c"
+    # shellcheck disable=SC2086
+    if $cc -c $tflags -fcallgraph-info=su "$OUT/probe.c" -o "$OUT/probe.o" > /dev/null 2>&1; then
+        ciflags=-fcallgraph-info=su
+    fi
+
+    echo "$CONFIGS" | while IFS='|' read -r config cflags; do
+        [ -n "$config" ] || continue
+        obj="$OUT/$target$config.o"
+        # shellcheck disable=SC2086
+        if ! $cc -c -Wall -std=gnu99 $tflags -fstack-usage $ciflags -DMICRORL_IGNORE_USER_CONFIGS $cflags $SIZE_CFLAGS \
+                -I$INC $SRC -o "$obj" 2> "$OUT/err" \
+            || ! $cc -c -std=gnu99 $tflags -DMICRORL_IGNORE_USER_CONFIGS $cflags $SIZE_CFLAGS \
+                -I$INC "$OUT/sizeof.c" -o "$OUT/sizeof.o" 2>> "$OUT/err"; then
+            printf "%-6s %-22s build failed:\n" "$target" "$config"
+            sed 's/^/    /' "$OUT/err"
+            echo 1 > "$OUT/failed"
+            continue
+        fi
+        [ -s "$OUT/err" ] && sed 's/^/    /' "$OUT/err"
+
+        set -- $(${prefix}size "$obj" | awk 'NR == 2 { print $1, $2, $3 }')
+        sizeof=$(${prefix}nm -S "$OUT/sizeof.o" | awk '$4 == "microrl_sizeof" { print $2 }')
+        su="$OUT/$target$config.su"
+        frame=$(sort -t "$(printf '\t')" -k2,2nr "$su" | head -n 1 | awk -F '\t' '{ n = split($1, a, ":"); print $2, a[n] }')
+        input="-"
+        if [ -f "$OUT/$target$config.ci" ]; then
+            input=$(awk -v fn=microrl_processing_input -f examples/bench/stack_usage.awk "$OUT/$target$config.ci")
+        fi
+        printf "%-6s %-22s %7s %6s %6s %7d %6s %6s  %s\n" "$target" "$config" "$1" "$2" "$3" "0x$sizeof" \
+            "${input%% *}" "${frame%% *}" "${frame#* }"
+        if [ "$VERBOSE" -eq 1 ]; then
+            [ "$input" != "-" ] && echo "    worst case: ${input#* }"
+            print_stack "$su"
+        fi
+    done
+done
+
+if [ "$VERBOSE" -eq 0 ]; then
+    for target in $SELECTED; do
+        su="$OUT/$target$STACK_CONFIG.su"
+        if [ -f "$su" ]; then
+            echo
+            echo "Stack usage of functions, $target, config $STACK_CONFIG:"
+            print_stack "$su"
+        fi
+    done
+fi
+
+[ -f "$OUT/failed" ] && res=1
+exit $res
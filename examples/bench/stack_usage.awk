@@ -0,0 +1,75 @@
+#
+# Worst-case stack usage of function from call graph written by GCC with -fcallgraph-info=su.
+# Callbacks and library functions are not in the graph and are counted as 0 bytes.
+#
+# Usage: awk -v fn=microrl_processing_input -f stack_usage.awk microrl.ci
+# Prints worst-case stack usage in bytes and the call chain with stack frame of every function.
+#
+# This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+#
+
+# Get name of node from "title" or edge end from the passed field
+function field(str, key) {
+    sub("^.*" key ": \"", "", str)
+    sub(/".*$/, "", str)
+    return str
+}
+
+# Function name without file name
+function short_name(str) {
+    sub(/^.*:/, "", str)
+    return str
+}
+
+# Worst-case stack of node and its callees, recursion is counted once
+function worst(node,    i, cnt, callee_arr, callee_worst, max, max_callee) {
+    if (node in memo) {
+        return memo[node]
+    }
+    if (node in busy) {
+        return 0
+    }
+    busy[node] = 1
+    max = 0
+    max_callee = ""
+    cnt = split(edges[node], callee_arr, SUBSEP)
+    for (i = 2; i <= cnt; ++i) {
+        callee_worst = worst(callee_arr[i])
+        if (callee_worst > max) {
+            max = callee_worst
+            max_callee = callee_arr[i]
+        }
+    }
+    delete busy[node]
+    worst_callee[node] = max_callee
+    memo[node] = frame[node] + max
+    return memo[node]
+}
+
+/^node:/ {
+    node = field($0, "title")
+    frame[node] = 0
+    if (match($0, /[0-9]+ bytes/)) {
+        frame[node] = substr($0, RSTART, RLENGTH - 6) + 0
+    }
+    if (short_name(node) == fn) {
+        root = node
+    }
+}
+
+/^edge:/ {
+    edges[field($0, "sourcename")] = edges[field($0, "sourcename")] SUBSEP field($0, "targetname")
+}
+
+END {
+    if (root == "") {
+        print "-"
+        exit
+    }
+    total = worst(root)
+    chain = ""
+    for (node = root; node != ""; node = worst_callee[node]) {
+        chain = chain (chain == "" ? "" : " > ") short_name(node) "(" frame[node] ")"
+    }
+    print total, chain
+}
@@ -0,0 +1,429 @@
+/**
+ * \file            vt100.c
+ * \brief           VT100 screen model for host-side checks of MicroRL output
+ *
+ * Output of the library is passed to \ref vt100_write and drawn on a grid of characters
+ * with cursor, like terminal does it, so the final screen after a key sequence can be compared
+ * with the expected one, while output is counted by kind. Cursor movement, erasing, insertion
+ * and deletion of characters are supported, colors are skipped and all the other escape
+ * sequences are only counted as unknown. Lines are not wider than the screen, the last
+ * column wraps to the next line like in xterm.
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "vt100.h"
+
+#define VT100_PARAM_MAX                     9999    /* Larger parameters are cut */
+#define VT100_TAB_WIDTH                     8
+
+/**
+ * \brief           Get cell of screen
+ * \param[in]       vt: Screen model instance
+ * \param[in]       row: Row of screen
+ * \param[in]       col: Column of screen
+ * \return          Pointer to cell
+ */
+static char* prv_cell(const vt100_t* vt, size_t row, size_t col) {
+    return &vt->cell_arr[((vt->top + row) % vt->rows) * vt->cols + col];
+}
+
+/**
+ * \brief           Erase part of row
+ * \param[in,out]   vt: Screen model instance
+ * \param[in]       row: Row of screen
+ * \param[in]       from: The first column to erase
+ * \param[in]       to: Column after the last one to erase
+ */
+static void prv_erase(vt100_t* vt, size_t row, size_t from, size_t to) {
+    if (from < to) {
+        memset(prv_cell(vt, row, from), ' ', to - from);
+    }
+}
+
+/**
+ * \brief           Move cursor to the next row, scroll screen up at the bottom
+ * \param[in,out]   vt: Screen model instance
+ */
+static void prv_line_feed(vt100_t* vt) {
+    if (vt->row + 1 < vt->rows) {
+        ++vt->row;
+    } else {
+        prv_erase(vt, 0, 0, vt->cols);          /* The top row becomes the bottom one */
+        vt->top = (vt->top + 1) % vt->rows;
+    }
+}
+
+/**
+ * \brief           Put printable character at cursor
+ * \param[in,out]   vt: Screen model instance
+ * \param[in]       ch: Character
+ */
+static void prv_print(vt100_t* vt, char ch) {
+    if (vt->wrap_pending) {
+        vt->wrap_pending = 0;
+        vt->col = 0;
+        prv_line_feed(vt);
+    }
+    *prv_cell(vt, vt->row, vt->col) = ch;
+    if (vt->col + 1 < vt->cols) {
+        ++vt->col;
+    } else {
+        vt->wrap_pending = 1;
+    }
+    ++vt->stats.printed;
+}
+
+/**
+ * \brief           Execute single byte control character
+ * \param[in,out]   vt: Screen model instance
+ * \param[in]       ch: Control character
+ */
+static void prv_control(vt100_t* vt, char ch) {
+    switch (ch) {
+        case '\r':
+            vt->col = 0;
+            break;
+        case '\n':
+        case '\v':
+        case '\f':
+            prv_line_feed(vt);
+            break;
+        case '\b':
+            if (vt->col > 0) {
+                --vt->col;
+            }
+            break;
+        case '\t':
+            vt->col = (vt->col / VT100_TAB_WIDTH + 1) * VT100_TAB_WIDTH;
+            if (vt->col >= vt->cols) {
+                vt->col = vt->cols - 1;
+            }
+            break;
+        default:                                /* BEL and others don't change screen */
+            break;
+    }
+    vt->wrap_pending = 0;
+    ++vt->stats.controls;
+}
+
+/**
+ * \brief           Get parameter of control sequence
+ * \param[in]       vt: Screen model instance
+ * \param[in]       idx: Index of parameter
+ * \param[in]       def: Value of missing or zero parameter
+ * \return          Parameter value
+ */
+static size_t prv_param(const vt100_t* vt, size_t idx, size_t def) {
+    if (idx >= vt->param_cnt || vt->param_arr[idx] == 0) {
+        return def;
+    }
+    return vt->param_arr[idx];
+}
+
+/**
+ * \brief           Limit value to range
+ * \param[in]       val: Value
+ * \param[in]       max: Maximum value
+ * \return          Value not greater than maximum
+ */
+static size_t prv_limit(size_t val, size_t max) {
+    return (val > max) ? max : val;
+}
+
+/**
+ * \brief           Execute control sequence `ESC [ params final`
+ * \param[in,out]   vt: Screen model instance
+ * \param[in]       final: Final character of sequence
+ */
+static void prv_csi_dispatch(vt100_t* vt, char final) {
+    size_t n = prv_param(vt, 0, 1);
+    size_t mode = (vt->param_cnt > 0) ? vt->param_arr[0] : 0;
+
+    vt->wrap_pending = 0;
+    switch (final) {
+        case 'A':                               /* CUU: cursor up */
+            vt->row -= prv_limit(n, vt->row);
+            break;
+        case 'B':                               /* CUD: cursor down */
+            vt->row = prv_limit(vt->row + n, vt->rows - 1);
+            break;
+        case 'C':                               /* CUF: cursor forward */
+            vt->col = prv_limit(vt->col + n, vt->cols - 1);
+            break;
+        case 'D':                               /* CUB: cursor back */
+            vt->col -= prv_limit(n, vt->col);
+            break;
+        case 'G':                               /* CHA: cursor to column */
+            vt->col = prv_limit(n - 1, vt->cols - 1);
+            break;
+        case 'd':                               /* VPA: cursor to row */
+            vt->row = prv_limit(n - 1, vt->rows - 1);
+            break;
+        case 'H':                               /* CUP: cursor to row and column */
+        case 'f':
+            vt->row = prv_limit(n - 1, vt->rows - 1);
+            vt->col = prv_limit(prv_param(vt, 1, 1) - 1, vt->cols - 1);
+            break;
+        case 'J':                               /* ED: erase in display */
+            if (mode == 0) {
+                prv_erase(vt, vt->row, vt->col, vt->cols);
+                for (size_t r = vt->row + 1; r < vt->rows; ++r) {
+                    prv_erase(vt, r, 0, vt->cols);
+                }
+            } else if (mode == 1) {
+                for (size_t r = 0; r < vt->row; ++r) {
+                    prv_erase(vt, r, 0, vt->cols);
+                }
+                prv_erase(vt, vt->row, 0, vt->col + 1);
+            } else {
+                for (size_t r = 0; r < vt->rows; ++r) {
+                    prv_erase(vt, r, 0, vt->cols);
+                }
+            }
+            break;
+        case 'K':                               /* EL: erase in line */
+            if (mode == 0) {
+                prv_erase(vt, vt->row, vt->col, vt->cols);
+            } else if (mode == 1) {
+                prv_erase(vt, vt->row, 0, vt->col + 1);
+            } else {
+                prv_erase(vt, vt->row, 0, vt->cols);
+            }
+            break;
+        case '@': {                             /* ICH: insert blank characters */
+            char* cell_ptr = prv_cell(vt, vt->row, vt->col);
+            n = prv_limit(n, vt->cols - vt->col);
+            memmove(cell_ptr + n, cell_ptr, vt->cols - vt->col - n);
+            memset(cell_ptr, ' ', n);
+            break;
+        }
+        case 'P': {                             /* DCH: delete characters */
+            char* cell_ptr = prv_cell(vt, vt->row, vt->col);
+            n = prv_limit(n, vt->cols - vt->col);
+            memmove(cell_ptr, cell_ptr + n, vt->cols - vt->col - n);
+            prv_erase(vt, vt->row, vt->cols - n, vt->cols);
+            break;
+        }
+        case 'X':                               /* ECH: erase characters */
+            prv_erase(vt, vt->row, vt->col, vt->col + prv_limit(n, vt->cols - vt->col));
+            break;
+        case 's':                               /* Save cursor */
+            vt->saved_row = vt->row;
+            vt->saved_col = vt->col;
+            break;
+        case 'u':                               /* Restore cursor */
+            vt->row = vt->saved_row;
+            vt->col = vt->saved_col;
+            break;
+        case 'm':                               /* SGR: colors don't change text */
+        case 'h':                               /* Modes */
+        case 'l':
+            break;
+        default:
+            ++vt->stats.unknown;
+            break;
+    }
+}
+
+/**
+ * \brief           Finish escape sequence
+ * \param[in,out]   vt: Screen model instance
+ */
+static void prv_seq_end(vt100_t* vt) {
+    vt->state = VT100_STATE_GROUND;
+    ++vt->stats.seqs;
+    vt->stats.seq_bytes += vt->seq_len;
+}
+
+/**
+ * \brief           Initialize screen model, screen is cleared and cursor is at home position
+ * \param[out]      vt: Screen model instance
+ * \param[in]       rows: Screen height
+ * \param[in]       cols: Screen width
+ * \return          `0` on success, `-1` otherwise
+ */
+int vt100_init(vt100_t* vt, size_t rows, size_t cols) {
+    if (vt == NULL || rows == 0 || cols == 0) {
+        return -1;
+    }
+
+    memset(vt, 0x00, sizeof(vt100_t));
+    vt->cell_arr = malloc(rows * cols);
+    if (vt->cell_arr == NULL) {
+        return -1;
+    }
+    vt->rows = rows;
+    vt->cols = cols;
+    vt100_reset(vt);
+
+    return 0;
+}
+
+/**
+ * \brief           Free screen model
+ * \param[in,out]   vt: Screen model instance
+ */
+void vt100_deinit(vt100_t* vt) {
+    free(vt->cell_arr);
+    vt->cell_arr = NULL;
+}
+
+/**
+ * \brief           Clear screen, move cursor to home position and reset counters
+ * \param[in,out]   vt: Screen model instance
+ */
+void vt100_reset(vt100_t* vt) {
+    memset(vt->cell_arr, ' ', vt->rows * vt->cols);
+    vt->top = vt->row = vt->col = 0;
+    vt->saved_row = vt->saved_col = 0;
+    vt->wrap_pending = 0;
+    vt->state = VT100_STATE_GROUND;
+    memset(&vt->stats, 0x00, sizeof(vt->stats));
+}
+
+/**
+ * \brief           Consume terminal output. Escape sequence may be split between calls
+ * \param[in,out]   vt: Screen model instance
+ * \param[in]       data_ptr: Output
+ * \param[in]       len: Length of output
+ */
+void vt100_write(vt100_t* vt, const char* data_ptr, size_t len) {
+    vt->stats.bytes += len;
+
+    for (size_t i = 0; i < len; ++i) {
+        char ch = data_ptr[i];
+
+        if (vt->state != VT100_STATE_GROUND) {
+            ++vt->seq_len;
+        }
+        switch (vt->state) {
+            case VT100_STATE_GROUND:
+                if (ch == '\033') {
+                    vt->state = VT100_STATE_ESC;
+                    vt->seq_len = 1;
+                } else if ((unsigned char)ch < 0x20) {
+                    prv_control(vt, ch);
+                } else if (ch != 0x7F) {
+                    prv_print(vt, ch);
+                }
+                break;
+            case VT100_STATE_ESC:
+                if (ch == '[') {
+                    vt->state = VT100_STATE_CSI;
+                    vt->param_cnt = 0;
+                    memset(vt->param_arr, 0x00, sizeof(vt->param_arr));
+                    break;
+                }
+                if (ch == '7') {                /* Save cursor */
+                    vt->saved_row = vt->row;
+                    vt->saved_col = vt->col;
+                } else if (ch == '8') {         /* Restore cursor */
+                    vt->row = vt->saved_row;
+                    vt->col = vt->saved_col;
+                } else {
+                    ++vt->stats.unknown;
+                }
+                prv_seq_end(vt);
+                break;
+            case VT100_STATE_CSI:
+                if (ch >= '0' && ch <= '9') {
+                    if (vt->param_cnt == 0) {
+                        vt->param_cnt = 1;
+                    }
+                    uint32_t* param_ptr = &vt->param_arr[vt->param_cnt - 1];
+                    *param_ptr = *param_ptr * 10 + (uint32_t)(ch - '0');
+                    if (*param_ptr > VT100_PARAM_MAX) {
+                        *param_ptr = VT100_PARAM_MAX;
+                    }
+                } else if (ch == ';') {
+                    if (vt->param_cnt == 0) {
+                        vt->param_cnt = 1;
+                    }
+                    if (vt->param_cnt < VT100_PARAM_NUM) {
+                        ++vt->param_cnt;
+                    }
+                } else if (ch >= 0x40 && ch <= 0x7E) {
+                    prv_csi_dispatch(vt, ch);
+                    prv_seq_end(vt);
+                } else if ((unsigned char)ch < 0x20) {
+                    prv_control(vt, ch);        /* Controls are executed inside of sequence too */
+                }                               /* Private markers and intermediates are skipped */
+                break;
+        }
+    }
+}
+
+/**
+ * \brief           Get text of screen row without trailing spaces
+ * \param[in]       vt: Screen model instance
+ * \param[in]       row: Row of screen, `0` is the top one
+ * \param[out]      str: Buffer for NULL-terminated text
+ * \param[in]       size: Size of buffer
+ * \return          Length of text
+ */
+size_t vt100_get_row(const vt100_t* vt, size_t row, char* str, size_t size) {
+    const char* cell_ptr = prv_cell(vt, row, 0);
+    size_t len = vt->cols;
+
+    while (len > 0 && cell_ptr[len - 1] == ' ') {
+        --len;
+    }
+    if (len + 1 > size) {
+        len = size - 1;
+    }
+    memcpy(str, cell_ptr, len);
+    str[len] = '\0';
+
+    return len;
+}
+
+/**
+ * \brief           Print screen up to the last non-empty row or cursor row and cursor position
+ * \param[in]       vt: Screen model instance
+ * \param[in]       file: Stream to print to
+ */
+void vt100_dump(const vt100_t* vt, FILE* file) {
+    size_t last = vt->row;
+
+    for (size_t r = vt->row + 1; r < vt->rows; ++r) {
+        const char* cell_ptr = prv_cell(vt, r, 0);
+        for (size_t c = 0; c < vt->cols; ++c) {
+            if (cell_ptr[c] != ' ') {
+                last = r;
+                break;
+            }
+        }
+    }
+    for (size_t r = 0; r <= last; ++r) {
+        const char* cell_ptr = prv_cell(vt, r, 0);
+        size_t len = vt->cols;
+
+        while (len > 0 && cell_ptr[len - 1] == ' ') {
+            --len;
+        }
+        fprintf(file, "%4zu|%.*s\n", r, (int)len, cell_ptr);
+    }
+    fprintf(file, "cursor at row %zu, column %zu\n", vt->row, vt->col);
+}
@@ -0,0 +1,93 @@
+/**
+ * \file            vt100.h
+ * \brief           VT100 screen model for host-side checks of MicroRL output
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#ifndef MICRORL_VT100_HDR_H
+#define MICRORL_VT100_HDR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define VT100_PARAM_NUM                     4   /*!< Maximum number of parameters of control sequence */
+
+/**
+ * \brief           State of escape sequence parser
+ */
+typedef enum {
+    VT100_STATE_GROUND,                         /*!< Printing characters */
+    VT100_STATE_ESC,                            /*!< ESC is received */
+    VT100_STATE_CSI                             /*!< ESC [ is received, parameters are collected */
+} vt100_state_t;
+
+/**
+ * \brief           Counters of output consumed by screen model
+ */
+typedef struct {
+    uint64_t bytes;                             /*!< All bytes */
+    uint64_t printed;                           /*!< Printable characters put on screen */
+    uint64_t controls;                          /*!< Single byte control characters, like CR, LF and BS */
+    uint64_t seqs;                              /*!< Escape sequences */
+    uint64_t seq_bytes;                         /*!< Bytes of escape sequences */
+    uint64_t unknown;                           /*!< Escape sequences, that screen model doesn't support */
+} vt100_stats_t;
+
+/**
+ * \brief           Screen model instance.
+ *                      Rows are stored in a ring, so scrolling doesn't move the screen
+ */
+typedef struct {
+    char* cell_arr;                             /*!< Characters of screen, `rows` by `cols` */
+    size_t rows;                                /*!< Screen height */
+    size_t cols;                                /*!< Screen width */
+    size_t top;                                 /*!< Row of ring shown at the top of screen */
+    size_t row;                                 /*!< Cursor row */
+    size_t col;                                 /*!< Cursor column */
+    size_t saved_row;                           /*!< Row saved by `ESC 7` or `ESC [ s` */
+    size_t saved_col;                           /*!< Column saved by `ESC 7` or `ESC [ s` */
+    uint8_t wrap_pending;                       /*!< Cursor is past the last column, the next character wraps */
+    vt100_state_t state;                        /*!< Escape sequence parser state */
+    uint32_t param_arr[VT100_PARAM_NUM];        /*!< Parameters of control sequence */
+    size_t param_cnt;                           /*!< Number of parameters of control sequence */
+    size_t seq_len;                             /*!< Length of escape sequence being parsed */
+    vt100_stats_t stats;                        /*!< Counters of consumed output */
+} vt100_t;
+
+int     vt100_init(vt100_t* vt, size_t rows, size_t cols);
+void    vt100_deinit(vt100_t* vt);
+void    vt100_reset(vt100_t* vt);
+void    vt100_write(vt100_t* vt, const char* data_ptr, size_t len);
+size_t  vt100_get_row(const vt100_t* vt, size_t row, char* str, size_t size);
+void    vt100_dump(const vt100_t* vt, FILE* file);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICRORL_VT100_HDR_H */
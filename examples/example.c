@@ -55,9 +55,14 @@ int main (void/*int argc, char** argv*/) {
 #endif /* MICRORL_CFG_USE_CTRL_C */
 
     while (1) {
+#if MICRORL_CFG_USE_INPUT_RING
+        /* Put all chars received in interrupt to microrl instance at once */
+        microrl_input_ring_drain(prl, &rx_ring);
+#else
         /* Put received char from stdin to microrl instance */
         char ch = get_char();
         microrl_processing_input(prl, &ch, 1);
+#endif /* MICRORL_CFG_USE_INPUT_RING */
     }
     return 0;
 }
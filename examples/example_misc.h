@@ -39,6 +39,10 @@ int    execute(microrl_t* mrl, int argc, const char* const *argv);
 char** complete(microrl_t* mrl, int argc, const char* const *argv);
 void   sigint(microrl_t* mrl);
 
+#if MICRORL_CFG_USE_INPUT_RING
+extern microrl_input_ring_t rx_ring;
+#endif /* MICRORL_CFG_USE_INPUT_RING */
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -40,11 +40,17 @@ extern "C" {
 #define MICRORL_CFG_PROMPT_STRING             "> "
 #define MICRORL_CFG_PROMPT_COLOR              "\033[32m"
 #define MICRORL_CFG_USE_COMPLETE              1
+#define MICRORL_CFG_USE_COMPLETE_CYCLE        1
+#define MICRORL_CFG_USE_COMPLETE_FUZZY        1
+#define MICRORL_CFG_TERMINAL_WIDTH            80
+#define MICRORL_CFG_COMPL_QUERY_ITEMS         100
 #define MICRORL_CFG_USE_QUOTING               1
 #define MICRORL_CFG_USE_ECHO_OFF              1
 #define MICRORL_CFG_ECHO_OFF_MASK             '*'
 #define MICRORL_CFG_USE_HISTORY               1
 #define MICRORL_CFG_RING_HISTORY_LEN          64
+#define MICRORL_CFG_USE_HISTORY_FRONT_CODING  1
+#define MICRORL_CFG_USE_HISTORY_HINTS         1
 #define MICRORL_CFG_PRINT_BUFFER_LEN          40
 #define MICRORL_CFG_USE_ESC_SEQ               1
 #define MICRORL_CFG_USE_LIBC_STDIO            0
@@ -52,6 +58,10 @@ extern "C" {
 #define MICRORL_CFG_USE_CTRL_C                1
 #define MICRORL_CFG_PROMPT_ON_INIT            1
 #define MICRORL_CFG_END_LINE                  "\r\n"
+#if defined(STM32F415xx)                    /* STM32 demo receives input in UART interrupt */
+#define MICRORL_CFG_USE_INPUT_RING            1
+#define MICRORL_CFG_INPUT_RING_LEN            128
+#endif /* defined(STM32F415xx) */
 
 #define MICRORL_CFG_USE_COMMAND_HOOKS         1
 #define MICRORL_PRE_COMMAND_HOOK(mrl, argc, argv)             /* Igrnore before command execution hook */
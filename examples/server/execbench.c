@@ -0,0 +1,307 @@
+/**
+ * \file            execbench.c
+ * \brief           Benchmark of work-stealing executor of MicroRL commands
+ *
+ * Many sessions type numbered commands, some of them are long. The main thread plays
+ * the role of server thread: it feeds input to sessions, passes entered commands to
+ * the executor and finishes them with \ref microrl_command_complete. Every session has
+ * one more line typed ahead while its command runs, so workers always have jobs, and
+ * the order of commands of every session is checked. Commands spin on CPU instead of
+ * sleeping, so the rate grows only with the number of cores.
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "executor.h"
+
+/**
+ * \brief           Benchmark session
+ */
+typedef struct {
+    microrl_t mrl;                              /*!< MicroRL instance, must be the first member */
+    executor_job_t job;                         /*!< Command passed to executor */
+    uint32_t rnd;                               /*!< State of generator of command types */
+    uint32_t typed_seq;                         /*!< Number of the last typed command */
+    uint32_t exec_seq;                          /*!< Number of the last executed command */
+    uint64_t out_bytes;                         /*!< Number of output bytes */
+} bench_session_t;
+
+static microrl_config_t cfg;
+static bench_session_t* sess_arr;
+static size_t sess_cnt = 1000;
+static unsigned long long_pct = 10;
+static double long_us = 200.0;
+static double short_us = 2.0;
+static uint64_t long_iter;
+static uint64_t short_iter;
+static uint64_t order_err_cnt;
+
+/**
+ * \brief           Get monotonic time
+ * \return          Time in nanoseconds
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief           Do some work on CPU
+ * \param[in]       iter: Number of iterations
+ * \return          Result, that can't be optimized out
+ */
+static uint32_t spin(uint64_t iter) {
+    uint32_t x = 1;
+
+    for (uint64_t i = 0; i < iter; ++i) {
+        x = x * 1664525u + 1013904223u;
+        __asm__ volatile("" : "+r"(x));
+    }
+    return x;
+}
+
+/**
+ * \brief           Output callback, counts output of session
+ * \param[in]       mrl: \ref microrl_t instance of session
+ * \param[in]       str: Output string
+ * \return          Number of characters
+ */
+static int bench_print(microrl_t* mrl, const char* str) {
+    size_t len = strlen(str);
+
+    ((bench_session_t*)mrl)->out_bytes += len;
+    return (int)len;
+}
+
+/**
+ * \brief           Execute callback, called by workers
+ * \param[in]       mrl: \ref microrl_t instance of session
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          '0' on success, '1' otherwise
+ */
+static int execute(microrl_t* mrl, int argc, const char* const *argv) {
+    bench_session_t* sess_ptr = (bench_session_t*)mrl;
+    char str[32];
+
+    if (argc != 2) {
+        return 1;
+    }
+
+    uint32_t seq = (uint32_t)strtoul(argv[1], NULL, 10);
+    if (seq != sess_ptr->exec_seq + 1) {
+        __atomic_fetch_add(&order_err_cnt, 1, __ATOMIC_RELAXED);
+    }
+    sess_ptr->exec_seq = seq;
+
+    snprintf(str, sizeof(str), "%s %08x" MICRORL_CFG_END_LINE, argv[0],
+             (unsigned)spin(argv[0][0] == 'l' ? long_iter : short_iter));
+    bench_print(mrl, str);
+
+    return 0;
+}
+
+/**
+ * \brief           Type the next command in session
+ * \param[in,out]   sess_ptr: Session
+ */
+static void session_type(bench_session_t* sess_ptr) {
+    char str[32];
+
+    sess_ptr->rnd = sess_ptr->rnd * 1103515245u + 12345u;
+    int len = snprintf(str, sizeof(str), "%s %u\r", ((sess_ptr->rnd >> 16) % 100 < long_pct) ? "long" : "short",
+                       (unsigned)++sess_ptr->typed_seq);
+    microrl_processing_input(&sess_ptr->mrl, str, (size_t)len);
+}
+
+/**
+ * \brief           Pass entered command of session to executor
+ * \param[in,out]   exe: Executor instance
+ * \param[in,out]   sess_ptr: Session
+ * \return          `1` if command is passed, `0` otherwise
+ */
+static int session_submit(executor_t* exe, bench_session_t* sess_ptr) {
+    microrl_event_t evt;
+
+    if (microrl_poll_event(&sess_ptr->mrl, &evt) != microrlOK || evt.type != MICRORL_EVENT_LINE) {
+        return 0;
+    }
+    sess_ptr->job.mrl = &sess_ptr->mrl;
+    sess_ptr->job.argc = evt.argc;
+    sess_ptr->job.argv = evt.argv;
+    executor_submit(exe, &sess_ptr->job);
+
+    return 1;
+}
+
+/**
+ * \brief           Run benchmark with given number of workers
+ * \param[in]       worker_cnt: Number of worker threads
+ * \param[in]       duration_s: Duration in seconds
+ * \param[out]      steal_cnt: Number of stolen jobs
+ * \return          Commands per second, `-1` on error
+ */
+static double bench_run(size_t worker_cnt, double duration_s, uint64_t* steal_cnt) {
+    executor_t exe;
+    size_t active_cnt = 0;
+    uint64_t done_cnt = 0;
+
+    if (executor_init(&exe, execute, worker_cnt) != 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < sess_cnt; ++i) {
+        bench_session_t* sess_ptr = &sess_arr[i];
+
+        sess_ptr->rnd = (uint32_t)i;
+        sess_ptr->typed_seq = sess_ptr->exec_seq = 0;
+        microrl_init_shared(&sess_ptr->mrl, &cfg);
+        session_type(sess_ptr);
+        session_type(sess_ptr);                 /* Typed ahead */
+        active_cnt += (size_t)session_submit(&exe, sess_ptr);
+    }
+
+    uint64_t start_ns = now_ns();
+    uint64_t end_ns = start_ns + (uint64_t)(duration_s * 1e9);
+    uint64_t stop_ns = start_ns;
+    struct pollfd pfd = {.fd = exe.event_fd, .events = POLLIN};
+    while (active_cnt != 0) {
+        uint8_t typing = (stop_ns < end_ns);
+
+        poll(&pfd, 1, 100);
+        for (executor_job_t* job = executor_collect(&exe); job != NULL;) {
+            bench_session_t* sess_ptr = (bench_session_t*)job->mrl;
+
+            job = job->next_ptr;
+            --active_cnt;
+            if (typing) {
+                ++done_cnt;
+            }
+            microrl_command_complete(&sess_ptr->mrl, 0);
+            if (typing) {
+                session_type(sess_ptr);
+            }
+            active_cnt += (size_t)session_submit(&exe, sess_ptr);
+        }
+        if (typing) {
+            stop_ns = now_ns();
+        }
+    }
+
+    *steal_cnt = exe.steal_cnt;
+    executor_deinit(&exe);
+
+    return (double)done_cnt / ((double)(stop_ns - start_ns) / 1e9);
+}
+
+/**
+ * \brief           Print usage
+ * \param[in]       name: Program name
+ */
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-s sessions] [-w workers] [-d seconds] [-l percent] [-t us] [-u us]\n"
+                    "  -s num   number of sessions (1000)\n"
+                    "  -w num   maximum number of workers, doubled from 1 (number of CPUs)\n"
+                    "  -d sec   duration of every run (2)\n"
+                    "  -l pct   percent of long commands (10)\n"
+                    "  -t us    CPU time of long command (200)\n"
+                    "  -u us    CPU time of short command (2)\n", name);
+}
+
+/**
+ * \brief           Program entry point
+ */
+int main(int argc, char** argv) {
+    long cpu_cnt = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t worker_max = (cpu_cnt > 0) ? (size_t)cpu_cnt : 1;
+    double duration_s = 2.0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:w:d:l:t:u:h")) != -1) {
+        switch (opt) {
+            case 's': sess_cnt = strtoul(optarg, NULL, 0); break;
+            case 'w': worker_max = strtoul(optarg, NULL, 0); break;
+            case 'd': duration_s = strtod(optarg, NULL); break;
+            case 'l': long_pct = strtoul(optarg, NULL, 0); break;
+            case 't': long_us = strtod(optarg, NULL); break;
+            case 'u': short_us = strtod(optarg, NULL); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if (sess_cnt == 0 || worker_max == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    sess_arr = calloc(sess_cnt, sizeof(bench_session_t));
+    if (sess_arr == NULL) {
+        perror("calloc");
+        return 1;
+    }
+    microrl_config_init(&cfg, bench_print, NULL);
+
+    uint64_t t_ns = now_ns();                   /* Calibrate work of commands */
+    spin(10000000);
+    double iter_per_us = 10000000.0 / ((double)(now_ns() - t_ns) / 1e3);
+    long_iter = (uint64_t)(long_us * iter_per_us);
+    short_iter = (uint64_t)(short_us * iter_per_us);
+
+    printf("%ld CPUs, %zu sessions, %lu%% long commands of %.0f us, short commands of %.1f us\n",
+           cpu_cnt, sess_cnt, long_pct, long_us, short_us);
+    printf("workers  commands/s  speedup     stolen\n");
+
+    double base = 0;
+    for (size_t worker_cnt = 1;; worker_cnt *= 2) {
+        uint64_t steal_cnt = 0;
+
+        if (worker_cnt > worker_max) {
+            worker_cnt = worker_max;
+        }
+        double rate = bench_run(worker_cnt, duration_s, &steal_cnt);
+        if (rate < 0) {
+            perror("executor_init");
+            return 1;
+        }
+        if (base == 0) {
+            base = rate;
+        }
+        printf("%7zu  %10.0f  %7.2f  %9llu\n", worker_cnt, rate, rate / base, (unsigned long long)steal_cnt);
+        fflush(stdout);
+        if (worker_cnt == worker_max) {
+            break;
+        }
+    }
+
+    if (order_err_cnt != 0) {
+        printf("Commands of sessions executed out of order: %llu\n", (unsigned long long)order_err_cnt);
+        return 1;
+    }
+    free(sess_arr);
+
+    return 0;
+}
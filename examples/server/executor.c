@@ -0,0 +1,314 @@
+/**
+ * \file            executor.c
+ * \brief           Work-stealing executor of MicroRL commands for multi-session hosts
+ *
+ * Commands entered in sessions are queued to workers in turn. Every worker takes the oldest
+ * job of its own queue, and when the queue is empty, it takes the older half of the queue
+ * of another worker, so short commands don't wait behind a long one.
+ *
+ * A session has at most one job at a time: the next line is raised by MicroRL only after
+ * \ref microrl_command_complete, so commands of a session run in the order they are entered.
+ * Until the job is collected, the session and its output buffer belong to the worker,
+ * execute callback prints with the output callback of the session as usual.
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "executor.h"
+
+/**
+ * \brief           Take the oldest job from own queue of worker
+ * \param[in,out]   wrk: Worker
+ * \return          Job or `NULL` if queue is empty
+ */
+static executor_job_t* prv_worker_pop(executor_worker_t* wrk) {
+    executor_job_t* job = NULL;
+
+    pthread_mutex_lock(&wrk->mtx);
+    if (wrk->head_ptr != NULL) {
+        job = wrk->head_ptr;
+        wrk->head_ptr = job->next_ptr;
+        if (wrk->head_ptr == NULL) {
+            wrk->tail_ptr = NULL;
+        }
+        __atomic_store_n(&wrk->job_cnt, wrk->job_cnt - 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&wrk->mtx);
+
+    return job;
+}
+
+/**
+ * \brief           Take the older half of the queue of another worker.
+ *                      The first job is returned, the rest are moved to own queue
+ * \param[in,out]   wrk: Worker, that steals
+ * \return          Job or `NULL` if queues of all workers are empty
+ */
+static executor_job_t* prv_worker_steal(executor_worker_t* wrk) {
+    executor_t* exe = wrk->exe_ptr;
+    size_t idx = (size_t)(wrk - exe->worker_arr);
+
+    for (size_t i = 1; i < exe->worker_cnt; ++i) {
+        executor_worker_t* victim_ptr = &exe->worker_arr[(idx + i) % exe->worker_cnt];
+        executor_job_t* first_ptr;
+        executor_job_t* last_ptr;
+        size_t cnt;
+
+        if (__atomic_load_n(&victim_ptr->job_cnt, __ATOMIC_RELAXED) == 0) {
+            continue;                           /* Don't lock empty queues */
+        }
+
+        pthread_mutex_lock(&victim_ptr->mtx);
+        cnt = (victim_ptr->job_cnt + 1) / 2;
+        first_ptr = last_ptr = victim_ptr->head_ptr;
+        if (cnt != 0) {
+            for (size_t n = 1; n < cnt; ++n) {
+                last_ptr = last_ptr->next_ptr;
+            }
+            victim_ptr->head_ptr = last_ptr->next_ptr;
+            if (victim_ptr->head_ptr == NULL) {
+                victim_ptr->tail_ptr = NULL;
+            }
+            __atomic_store_n(&victim_ptr->job_cnt, victim_ptr->job_cnt - cnt, __ATOMIC_RELAXED);
+        }
+        pthread_mutex_unlock(&victim_ptr->mtx);
+
+        if (cnt == 0) {
+            continue;
+        }
+        last_ptr->next_ptr = NULL;
+        __atomic_fetch_add(&exe->steal_cnt, cnt, __ATOMIC_RELAXED);
+
+        if (cnt > 1) {
+            pthread_mutex_lock(&wrk->mtx);
+            if (wrk->tail_ptr != NULL) {
+                wrk->tail_ptr->next_ptr = first_ptr->next_ptr;
+            } else {
+                wrk->head_ptr = first_ptr->next_ptr;
+            }
+            wrk->tail_ptr = last_ptr;
+            __atomic_store_n(&wrk->job_cnt, wrk->job_cnt + cnt - 1, __ATOMIC_RELAXED);
+            pthread_mutex_unlock(&wrk->mtx);
+        }
+
+        return first_ptr;
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief           Pass finished job to the host
+ * \param[in,out]   exe: Executor instance
+ * \param[in]       job: Finished job
+ */
+static void prv_executor_done(executor_t* exe, executor_job_t* job) {
+    uint64_t one = 1;
+    int wake;
+
+    pthread_mutex_lock(&exe->done_mtx);
+    job->next_ptr = exe->done_ptr;
+    exe->done_ptr = job;
+    wake = (job->next_ptr == NULL);
+    pthread_mutex_unlock(&exe->done_mtx);
+
+    if (wake) {                                 /* Event is left set until the list is collected */
+        ssize_t res = write(exe->event_fd, &one, sizeof(one));
+        (void)res;
+    }
+}
+
+/**
+ * \brief           Worker thread
+ * \param[in]       arg: Worker
+ * \return          `NULL`
+ */
+static void* prv_worker_run(void* arg) {
+    executor_worker_t* wrk = arg;
+    executor_t* exe = wrk->exe_ptr;
+
+    for (;;) {
+        executor_job_t* job = prv_worker_pop(wrk);
+
+        if (job == NULL) {
+            job = prv_worker_steal(wrk);
+        }
+        if (job != NULL) {
+            __atomic_fetch_sub(&exe->queued_cnt, 1, __ATOMIC_SEQ_CST);
+            job->status = exe->exec_fn(job->mrl, job->argc, job->argv);
+            prv_executor_done(exe, job);
+            continue;
+        }
+
+        /*
+         * Submitter increments queued count before it checks idle count,
+         * worker does it vice versa, so either the job is seen here or the worker is signaled
+         */
+        pthread_mutex_lock(&exe->idle_mtx);
+        __atomic_fetch_add(&exe->idle_cnt, 1, __ATOMIC_SEQ_CST);
+        while (!exe->stop && __atomic_load_n(&exe->queued_cnt, __ATOMIC_SEQ_CST) == 0) {
+            pthread_cond_wait(&exe->idle_cond, &exe->idle_mtx);
+        }
+        __atomic_fetch_sub(&exe->idle_cnt, 1, __ATOMIC_SEQ_CST);
+        uint8_t stop = exe->stop && __atomic_load_n(&exe->queued_cnt, __ATOMIC_SEQ_CST) == 0;
+        pthread_mutex_unlock(&exe->idle_mtx);
+
+        if (stop) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief           Stop workers after all queued jobs are executed
+ * \param[in,out]   exe: Executor instance
+ * \param[in]       thread_cnt: Number of started worker threads
+ */
+static void prv_executor_stop(executor_t* exe, size_t thread_cnt) {
+    pthread_mutex_lock(&exe->idle_mtx);
+    exe->stop = 1;
+    pthread_cond_broadcast(&exe->idle_cond);
+    pthread_mutex_unlock(&exe->idle_mtx);
+
+    for (size_t i = 0; i < thread_cnt; ++i) {
+        pthread_join(exe->worker_arr[i].thread, NULL);
+    }
+    for (size_t i = 0; i < exe->worker_cnt; ++i) {
+        pthread_mutex_destroy(&exe->worker_arr[i].mtx);
+    }
+    pthread_cond_destroy(&exe->idle_cond);
+    pthread_mutex_destroy(&exe->idle_mtx);
+    pthread_mutex_destroy(&exe->done_mtx);
+    free(exe->worker_arr);
+    close(exe->event_fd);
+}
+
+/**
+ * \brief           Initialize executor and start its workers
+ * \param[out]      exe: Executor instance
+ * \param[in]       exec_fn: Execute callback of all sessions, called by workers
+ * \param[in]       worker_cnt: Number of worker threads
+ * \return          `0` on success, `-1` otherwise
+ */
+int executor_init(executor_t* exe, microrl_exec_fn exec_fn, size_t worker_cnt) {
+    if (exe == NULL || exec_fn == NULL || worker_cnt == 0) {
+        return -1;
+    }
+
+    memset(exe, 0x00, sizeof(executor_t));
+    exe->exec_fn = exec_fn;
+    exe->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    exe->worker_arr = calloc(worker_cnt, sizeof(executor_worker_t));
+    if (exe->event_fd < 0 || exe->worker_arr == NULL) {
+        if (exe->event_fd >= 0) {
+            close(exe->event_fd);
+        }
+        free(exe->worker_arr);
+        return -1;
+    }
+
+    exe->worker_cnt = worker_cnt;
+    pthread_mutex_init(&exe->idle_mtx, NULL);
+    pthread_cond_init(&exe->idle_cond, NULL);
+    pthread_mutex_init(&exe->done_mtx, NULL);
+    for (size_t i = 0; i < worker_cnt; ++i) {   /* Workers steal from each other, so all queues are ready first */
+        exe->worker_arr[i].exe_ptr = exe;
+        pthread_mutex_init(&exe->worker_arr[i].mtx, NULL);
+    }
+    for (size_t i = 0; i < worker_cnt; ++i) {
+        if (pthread_create(&exe->worker_arr[i].thread, NULL, prv_worker_run, &exe->worker_arr[i]) != 0) {
+            prv_executor_stop(exe, i);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief           Queue command to execute.
+ *                      Call it from one thread, that processes input of sessions
+ * \param[in,out]   exe: Executor instance
+ * \param[in]       job: Job with session and arguments of \ref MICRORL_EVENT_LINE event
+ */
+void executor_submit(executor_t* exe, executor_job_t* job) {
+    executor_worker_t* wrk = &exe->worker_arr[exe->submit_idx];
+
+    if (++exe->submit_idx == exe->worker_cnt) {
+        exe->submit_idx = 0;
+    }
+
+    job->next_ptr = NULL;
+    __atomic_fetch_add(&exe->queued_cnt, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&wrk->mtx);
+    if (wrk->tail_ptr != NULL) {
+        wrk->tail_ptr->next_ptr = job;
+    } else {
+        wrk->head_ptr = job;
+    }
+    wrk->tail_ptr = job;
+    __atomic_store_n(&wrk->job_cnt, wrk->job_cnt + 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&wrk->mtx);
+
+    if (__atomic_load_n(&exe->idle_cnt, __ATOMIC_SEQ_CST) != 0) {
+        pthread_mutex_lock(&exe->idle_mtx);
+        pthread_cond_signal(&exe->idle_cond);
+        pthread_mutex_unlock(&exe->idle_mtx);
+    }
+}
+
+/**
+ * \brief           Get finished jobs. Call it when `event_fd` is readable,
+ *                      then finish every job with \ref microrl_command_complete
+ * \param[in,out]   exe: Executor instance
+ * \return          List of finished jobs linked by `next_ptr`, `NULL` if there are none
+ */
+executor_job_t* executor_collect(executor_t* exe) {
+    executor_job_t* job;
+    uint64_t cnt;
+
+    /* Event is cleared before the list is taken, so job finished meanwhile sets it again */
+    ssize_t res = read(exe->event_fd, &cnt, sizeof(cnt));
+    (void)res;
+
+    pthread_mutex_lock(&exe->done_mtx);
+    job = exe->done_ptr;
+    exe->done_ptr = NULL;
+    pthread_mutex_unlock(&exe->done_mtx);
+
+    return job;
+}
+
+/**
+ * \brief           Execute queued jobs, stop workers and free executor resources.
+ *                      Finished jobs, that are not collected, are dropped
+ * \param[in,out]   exe: Executor instance
+ */
+void executor_deinit(executor_t* exe) {
+    prv_executor_stop(exe, exe->worker_cnt);
+}
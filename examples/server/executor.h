@@ -0,0 +1,94 @@
+/**
+ * \file            executor.h
+ * \brief           Work-stealing executor of MicroRL commands for multi-session hosts
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#ifndef MICRORL_EXECUTOR_HDR_H
+#define MICRORL_EXECUTOR_HDR_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "microrl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Command of a session to execute.
+ *                      Job is owned by the executor from \ref executor_submit
+ *                      until it is returned by \ref executor_collect
+ */
+typedef struct executor_job {
+    struct executor_job* next_ptr;              /*!< Next job in queue */
+    microrl_t* mrl;                             /*!< Session the command is entered in */
+    int argc;                                   /*!< Argument count */
+    const char* const* argv;                    /*!< Arguments, valid until \ref microrl_command_complete */
+    int status;                                 /*!< Result of execute callback */
+} executor_job_t;
+
+struct executor;
+
+/**
+ * \brief           Worker thread with its own queue of jobs
+ */
+typedef struct executor_worker {
+    struct executor* exe_ptr;                   /*!< Executor the worker belongs to */
+    pthread_t thread;                           /*!< Worker thread */
+    pthread_mutex_t mtx;                        /*!< Protects queue of the worker */
+    executor_job_t* head_ptr;                   /*!< The oldest job, taken by the worker and thieves */
+    executor_job_t* tail_ptr;                   /*!< The newest job */
+    size_t job_cnt;                             /*!< Number of jobs in queue */
+} executor_worker_t;
+
+/**
+ * \brief           Executor instance
+ */
+typedef struct executor {
+    microrl_exec_fn exec_fn;                    /*!< Execute callback of all sessions */
+    executor_worker_t* worker_arr;              /*!< Workers */
+    size_t worker_cnt;                          /*!< Number of workers */
+    size_t submit_idx;                          /*!< Worker to queue the next job to */
+    size_t queued_cnt;                          /*!< Number of jobs queued to all workers */
+    size_t idle_cnt;                            /*!< Number of workers waiting for jobs */
+    uint8_t stop;                               /*!< Workers are stopped */
+    pthread_mutex_t idle_mtx;                   /*!< Protects waiting for jobs */
+    pthread_cond_t idle_cond;                   /*!< Signaled when job is queued */
+    pthread_mutex_t done_mtx;                   /*!< Protects list of finished jobs */
+    executor_job_t* done_ptr;                   /*!< Finished jobs */
+    int event_fd;                               /*!< Readable while there are finished jobs */
+    uint64_t steal_cnt;                         /*!< Number of jobs taken from queues of other workers */
+} executor_t;
+
+int     executor_init(executor_t* exe, microrl_exec_fn exec_fn, size_t worker_cnt);
+void    executor_submit(executor_t* exe, executor_job_t* job);
+executor_job_t* executor_collect(executor_t* exe);
+void    executor_deinit(executor_t* exe);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICRORL_EXECUTOR_HDR_H */
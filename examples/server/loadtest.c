@@ -0,0 +1,297 @@
+/**
+ * \file            loadtest.c
+ * \brief           Load test client for multi-session MicroRL server
+ *
+ * Opens many connections, types a command line into every one of them byte by byte,
+ * like a human does, and measures the time from sending a keystroke to receiving
+ * the first byte of its echo. One keystroke per connection is in flight at a time.
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define LAT_BUCKET_US                       10      /* Latency histogram resolution */
+#define LAT_BUCKETS                         1000000 /* Number of buckets, covers latencies up to 10 s */
+#define EPOLL_EVENTS                        256
+
+/**
+ * \brief           Client connection
+ */
+typedef struct {
+    int fd;                                     /*!< Socket */
+    size_t pos;                                 /*!< Position of the next keystroke in command line */
+    uint64_t sent_ns;                           /*!< Time the keystroke in flight was sent */
+    uint8_t wait;                               /*!< Keystroke is waiting for echo */
+} conn_t;
+
+static uint32_t lat_hist[LAT_BUCKETS + 1];    /* The last bucket counts all latencies above the limit */
+static uint64_t lat_cnt;
+static uint64_t lat_max_ns;
+static uint64_t rx_bytes;
+static uint64_t tx_bytes;
+
+/**
+ * \brief           Get monotonic time
+ * \return          Time in nanoseconds
+ */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * \brief           Get latency percentile from histogram
+ * \param[in]       pct: Percentile, 0..100
+ * \return          Latency in microseconds
+ */
+static double percentile_us(double pct) {
+    uint64_t target = (uint64_t)((double)lat_cnt * pct / 100.0);
+    uint64_t sum = 0;
+
+    if (target >= lat_cnt) {
+        target = lat_cnt - 1;
+    }
+    for (size_t i = 0; i <= LAT_BUCKETS; ++i) {
+        sum += lat_hist[i];
+        if (sum > target) {
+            return (double)(i * LAT_BUCKET_US);
+        }
+    }
+    return (double)(LAT_BUCKETS * LAT_BUCKET_US);
+}
+
+/**
+ * \brief           Connect to server
+ * \param[in]       addr_str: IPv4 address of server
+ * \param[in]       port: TCP port of server
+ * \param[in]       path_str: Unix socket path, or NULL to connect over TCP
+ * \return          Socket or `-1` on error
+ */
+static int conn_open(const char* addr_str, uint16_t port, const char* path_str) {
+    int fd;
+
+    if (path_str != NULL) {
+        struct sockaddr_un addr = {.sun_family = AF_UNIX};
+        strncpy(addr.sun_path, path_str, sizeof(addr.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+        int one = 1;
+        inet_pton(AF_INET, addr_str, &addr.sin_addr);
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    return fd;
+}
+
+/**
+ * \brief           Send the next keystroke of command line
+ * \param[in,out]   conn_ptr: Connection
+ * \param[in]       line_str: Command line to type, ending with '\r'
+ * \param[in]       line_len: Length of command line
+ * \return          `0` on success, `-1` if connection is broken
+ */
+static int conn_send_key(conn_t* conn_ptr, const char* line_str, size_t line_len) {
+    conn_ptr->sent_ns = now_ns();
+    if (send(conn_ptr->fd, line_str + conn_ptr->pos, 1, MSG_NOSIGNAL) != 1) {
+        return -1;
+    }
+    ++tx_bytes;
+    conn_ptr->wait = 1;
+    if (++conn_ptr->pos == line_len) {
+        conn_ptr->pos = 0;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief           Print usage
+ * \param[in]       name: Program name
+ */
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-a addr] [-p port] [-u path] [-c connections] [-d seconds] [-l line]\n"
+                    "  -a addr  IPv4 address of server (127.0.0.1)\n"
+                    "  -p port  TCP port of server (2323)\n"
+                    "  -u path  connect to Unix socket instead of TCP\n"
+                    "  -c num   number of connections (100)\n"
+                    "  -d sec   test duration (5)\n"
+                    "  -l line  command line to type repeatedly (\"echo hello world\")\n", name);
+}
+
+/**
+ * \brief           Program entry point
+ */
+int main(int argc, char** argv) {
+    const char* addr_str = "127.0.0.1";
+    const char* path_str = NULL;
+    const char* cmd_str = "echo hello world";
+    unsigned long port = 2323;
+    size_t conn_cnt = 100;
+    double duration_s = 5.0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:p:u:c:d:l:h")) != -1) {
+        switch (opt) {
+            case 'a': addr_str = optarg; break;
+            case 'p': port = strtoul(optarg, NULL, 0); break;
+            case 'u': path_str = optarg; break;
+            case 'c': conn_cnt = strtoul(optarg, NULL, 0); break;
+            case 'd': duration_s = strtod(optarg, NULL); break;
+            case 'l': cmd_str = optarg; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+
+    size_t line_len = strlen(cmd_str) + 1;
+    char* line_str = malloc(line_len + 1);
+    conn_t* conn_arr = calloc(conn_cnt, sizeof(conn_t));
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (line_str == NULL || conn_arr == NULL || epoll_fd < 0) {
+        perror("init");
+        return 1;
+    }
+    strcpy(line_str, cmd_str);
+    strcat(line_str, "\r");
+
+    uint64_t start_ns = now_ns();
+    for (size_t i = 0; i < conn_cnt; ++i) {
+        conn_arr[i].fd = conn_open(addr_str, (uint16_t)port, path_str);
+        if (conn_arr[i].fd < 0) {
+            fprintf(stderr, "connection %zu: %s\n", i, strerror(errno));
+            return 1;
+        }
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &conn_arr[i]};
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn_arr[i].fd, &ev);
+    }
+    printf("%zu connections opened in %.3f s\n", conn_cnt, (double)(now_ns() - start_ns) / 1e9);
+
+    /* Skip greeting and prompt */
+    usleep(200000);
+    char buf[4096];
+    for (size_t i = 0; i < conn_cnt; ++i) {
+        while (recv(conn_arr[i].fd, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+        }
+    }
+
+    start_ns = now_ns();
+    uint64_t end_ns = start_ns + (uint64_t)(duration_s * 1e9);
+    for (size_t i = 0; i < conn_cnt; ++i) {
+        if (conn_send_key(&conn_arr[i], line_str, line_len) != 0) {
+            perror("send");
+            return 1;
+        }
+    }
+
+    size_t conn_active = conn_cnt;
+    uint64_t stop_ns = end_ns;
+    struct epoll_event ev_arr[EPOLL_EVENTS];
+    while (conn_active != 0) {
+        int cnt = epoll_wait(epoll_fd, ev_arr, EPOLL_EVENTS, 100);
+        uint64_t t_ns = now_ns();
+
+        for (int i = 0; i < cnt; ++i) {
+            conn_t* conn_ptr = ev_arr[i].data.ptr;
+            ssize_t n = recv(conn_ptr->fd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (n <= 0) {
+                fprintf(stderr, "connection closed by server\n");
+                return 1;
+            }
+            rx_bytes += (uint64_t)n;
+
+            if (!conn_ptr->wait) {
+                continue;
+            }
+            uint64_t lat_ns = t_ns - conn_ptr->sent_ns;
+            uint64_t lat_idx = lat_ns / (1000 * LAT_BUCKET_US);
+            ++lat_hist[lat_idx < LAT_BUCKETS ? lat_idx : LAT_BUCKETS];
+            ++lat_cnt;
+            if (lat_ns > lat_max_ns) {
+                lat_max_ns = lat_ns;
+            }
+            conn_ptr->wait = 0;
+
+            if (t_ns < end_ns) {
+                if (conn_send_key(conn_ptr, line_str, line_len) != 0) {
+                    perror("send");
+                    return 1;
+                }
+            } else {
+                --conn_active;
+            }
+        }
+        if (t_ns > end_ns + 5000000000u) {
+            fprintf(stderr, "%zu connections didn't get echo in 5 s\n", conn_active);
+            break;
+        }
+        stop_ns = t_ns;
+    }
+
+    double elapsed_s = (double)(stop_ns - start_ns) / 1e9;
+    printf("Duration:     %.3f s\n", elapsed_s);
+    printf("Keystrokes:   %llu (%.0f per second)\n", (unsigned long long)lat_cnt, (double)lat_cnt / elapsed_s);
+    printf("Traffic:      tx %llu bytes, rx %llu bytes (%.2f MB/s)\n", (unsigned long long)tx_bytes,
+           (unsigned long long)rx_bytes, (double)(tx_bytes + rx_bytes) / elapsed_s / 1e6);
+    if (lat_cnt != 0) {
+        printf("Latency, us:  p50 %.0f, p90 %.0f, p99 %.0f, p99.9 %.0f, max %.0f\n", percentile_us(50),
+               percentile_us(90), percentile_us(99), percentile_us(99.9), (double)lat_max_ns / 1e3);
+    }
+
+    for (size_t i = 0; i < conn_cnt; ++i) {
+        close(conn_arr[i].fd);
+    }
+    free(conn_arr);
+    free(line_str);
+    close(epoll_fd);
+
+    return 0;
+}
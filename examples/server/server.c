@@ -0,0 +1,544 @@
+/**
+ * \file            server.c
+ * \brief           Multi-session MicroRL server over TCP or Unix sockets
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#define _GNU_SOURCE                                 /* accept4() */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "server.h"
+
+#if !MICRORL_CFG_USE_EVENTS
+#error "MICRORL_CFG_USE_EVENTS must be enabled to pass commands to executor"
+#endif /* !MICRORL_CFG_USE_EVENTS */
+
+#define SERVER_EPOLL_EVENTS                 256
+
+#define TELNET_IAC                          255
+#define TELNET_DONT                         254
+#define TELNET_DO                           253
+#define TELNET_WONT                         252
+#define TELNET_WILL                         251
+#define TELNET_SB                           250
+#define TELNET_SE                           240
+#define TELNET_OPT_ECHO                     1
+#define TELNET_OPT_SGA                      3
+#define TELNET_OPT_LINEMODE                 34
+
+/**
+ * \brief           States of telnet commands filter
+ */
+typedef enum {
+    TELNET_STATE_DATA = 0,                      /*!< Plain data */
+    TELNET_STATE_IAC,                           /*!< 'Interpret as command' byte is received */
+    TELNET_STATE_OPT,                           /*!< Option of negotiation command is expected */
+    TELNET_STATE_SB,                            /*!< Inside of subnegotiation */
+    TELNET_STATE_SB_IAC                         /*!< 'Interpret as command' byte inside of subnegotiation */
+} telnet_state_t;
+
+/**
+ * \brief           Send buffered output of session
+ * \param[in,out]   sess_ptr: Session
+ * \return          `0` on success, `-1` if connection is broken
+ */
+static int prv_session_flush(server_session_t* sess_ptr) {
+    while (sess_ptr->out_pos < sess_ptr->out_len) {
+        ssize_t n = send(sess_ptr->fd, sess_ptr->out_buf + sess_ptr->out_pos,
+                         sess_ptr->out_len - sess_ptr->out_pos, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return -1;
+        }
+        sess_ptr->out_pos += (size_t)n;
+        __atomic_fetch_add(&sess_ptr->srv_ptr->tx_bytes, (uint64_t)n, __ATOMIC_RELAXED);
+    }
+
+    if (sess_ptr->out_pos == sess_ptr->out_len) {
+        sess_ptr->out_pos = sess_ptr->out_len = 0;
+    } else if (sess_ptr->out_pos != 0) {        /* Keep unsent output at buffer start */
+        memmove(sess_ptr->out_buf, sess_ptr->out_buf + sess_ptr->out_pos, sess_ptr->out_len - sess_ptr->out_pos);
+        sess_ptr->out_len -= sess_ptr->out_pos;
+        sess_ptr->out_pos = 0;
+    }
+
+    uint8_t out_wait = (sess_ptr->out_len != 0);
+    if (out_wait != sess_ptr->out_wait && !sess_ptr->busy) {   /* Poll socket for writing only while output is pending */
+        struct epoll_event ev = {.events = EPOLLIN | (out_wait ? EPOLLOUT : 0), .data.ptr = sess_ptr};
+        epoll_ctl(sess_ptr->srv_ptr->epoll_fd, EPOLL_CTL_MOD, sess_ptr->fd, &ev);
+        sess_ptr->out_wait = out_wait;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief           Close session and free its memory
+ * \param[in]       sess_ptr: Session
+ */
+static void prv_session_free(server_session_t* sess_ptr) {
+    epoll_ctl(sess_ptr->srv_ptr->epoll_fd, EPOLL_CTL_DEL, sess_ptr->fd, NULL);
+    close(sess_ptr->fd);
+    __atomic_fetch_sub(&sess_ptr->srv_ptr->session_cnt, 1, __ATOMIC_RELAXED);
+    free(sess_ptr);
+}
+
+/**
+ * \brief           Remove telnet commands from received data in place
+ * \param[in,out]   sess_ptr: Session
+ * \param[in,out]   data_ptr: Received data
+ * \param[in]       len: Length of received data
+ * \return          Length of remaining data
+ */
+static size_t prv_session_telnet_filter(server_session_t* sess_ptr, char* data_ptr, size_t len) {
+    size_t out_len = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t ch = (uint8_t)data_ptr[i];
+
+        switch (sess_ptr->telnet_state) {
+            case TELNET_STATE_DATA: {
+                if (ch == TELNET_IAC) {
+                    sess_ptr->telnet_state = TELNET_STATE_IAC;
+                } else if (ch != '\0') {        /* Drop NUL sent after CR by telnet clients */
+                    data_ptr[out_len++] = (char)ch;
+                }
+                break;
+            }
+            case TELNET_STATE_IAC: {
+                if (ch == TELNET_IAC) {
+                    data_ptr[out_len++] = (char)ch;
+                    sess_ptr->telnet_state = TELNET_STATE_DATA;
+                } else if (ch >= TELNET_WILL && ch <= TELNET_DONT) {
+                    sess_ptr->telnet_state = TELNET_STATE_OPT;
+                } else if (ch == TELNET_SB) {
+                    sess_ptr->telnet_state = TELNET_STATE_SB;
+                } else {
+                    sess_ptr->telnet_state = TELNET_STATE_DATA;
+                }
+                break;
+            }
+            case TELNET_STATE_SB: {
+                if (ch == TELNET_IAC) {
+                    sess_ptr->telnet_state = TELNET_STATE_SB_IAC;
+                }
+                break;
+            }
+            case TELNET_STATE_SB_IAC: {
+                sess_ptr->telnet_state = (ch == TELNET_SE) ? TELNET_STATE_DATA : TELNET_STATE_SB;
+                break;
+            }
+            default: {
+                sess_ptr->telnet_state = TELNET_STATE_DATA;
+                break;
+            }
+        }
+    }
+
+    return out_len;
+}
+
+/**
+ * \brief           Read input of session and feed it to MicroRL at once.
+ *                      While command is executed, input is typed ahead without echo
+ * \param[in,out]   sess_ptr: Session
+ * \return          `0` on success, `-1` if session is closed
+ */
+static int prv_session_read(server_session_t* sess_ptr) {
+    char buf[SERVER_IN_BUF_LEN];
+    ssize_t n = recv(sess_ptr->fd, buf, sizeof(buf), 0);
+
+    if (n == 0) {
+        return -1;
+    }
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+    __atomic_fetch_add(&sess_ptr->srv_ptr->rx_bytes, (uint64_t)n, __ATOMIC_RELAXED);
+
+    size_t len = (size_t)n;
+    if (sess_ptr->srv_ptr->telnet) {
+        len = prv_session_telnet_filter(sess_ptr, buf, len);
+    }
+    if (len != 0 && (sess_ptr->busy || !sess_ptr->closing)) {
+        microrl_processing_input(&sess_ptr->mrl, buf, len);
+    }
+
+    return 0;
+}
+
+/**
+ * \brief           Pass entered command of session to executor
+ * \param[in,out]   sess_ptr: Session
+ */
+static void prv_session_submit(server_session_t* sess_ptr) {
+    microrl_event_t evt;
+
+    while (microrl_poll_event(&sess_ptr->mrl, &evt) == microrlOK) {
+        if (evt.type != MICRORL_EVENT_LINE) {
+            continue;                           /* Completion and Ctrl+C are handled by callbacks */
+        }
+        if (sess_ptr->out_wait) {               /* Unsent output is sent together with output of command */
+            struct epoll_event ev = {.events = EPOLLIN, .data.ptr = sess_ptr};
+            epoll_ctl(sess_ptr->srv_ptr->epoll_fd, EPOLL_CTL_MOD, sess_ptr->fd, &ev);
+            sess_ptr->out_wait = 0;
+        }
+        sess_ptr->job.mrl = &sess_ptr->mrl;
+        sess_ptr->job.argc = evt.argc;
+        sess_ptr->job.argv = evt.argv;
+        sess_ptr->busy = 1;
+        executor_submit(sess_ptr->srv_ptr->exe_ptr, &sess_ptr->job);
+        break;
+    }
+}
+
+/**
+ * \brief           Send output of session and pass its entered command to executor.
+ *                      Session is freed if connection is broken or session is closed
+ * \param[in,out]   sess_ptr: Session
+ * \param[in]       res: `-1` if connection is broken, `0` otherwise
+ */
+static void prv_session_update(server_session_t* sess_ptr, int res) {
+    if (sess_ptr->busy) {                       /* Session is freed when command is collected */
+        if (res != 0 && !sess_ptr->broken) {
+            sess_ptr->broken = 1;
+            epoll_ctl(sess_ptr->srv_ptr->epoll_fd, EPOLL_CTL_DEL, sess_ptr->fd, NULL);
+        }
+        return;
+    }
+
+    if (res == 0) {
+        res = prv_session_flush(sess_ptr);
+    }
+    if (res != 0 || (sess_ptr->closing && sess_ptr->out_len == 0)) {
+        prv_session_free(sess_ptr);
+        return;
+    }
+    if (sess_ptr->srv_ptr->exe_ptr != NULL && !sess_ptr->closing) {
+        prv_session_submit(sess_ptr);
+    }
+}
+
+/**
+ * \brief           Finish commands executed by executor
+ * \param[in,out]   srv: Server instance
+ */
+static void prv_server_complete(server_t* srv) {
+    executor_job_t* job = executor_collect(srv->exe_ptr);
+
+    while (job != NULL) {
+        executor_job_t* next_ptr = job->next_ptr;
+        server_session_t* sess_ptr = server_session(job->mrl);
+
+        sess_ptr->busy = 0;
+        if (sess_ptr->broken) {
+            prv_session_free(sess_ptr);
+        } else {
+            if (!sess_ptr->closing) {
+                microrl_command_complete(&sess_ptr->mrl, job->status);
+            }
+            prv_session_update(sess_ptr, 0);
+        }
+        job = next_ptr;
+    }
+}
+
+/**
+ * \brief           Accept all pending connections
+ * \param[in,out]   srv: Server instance
+ */
+static void prv_server_accept(server_t* srv) {
+    static const char telnet_str[] = {
+        (char)TELNET_IAC, (char)TELNET_WILL, TELNET_OPT_ECHO,
+        (char)TELNET_IAC, (char)TELNET_WILL, TELNET_OPT_SGA,
+        (char)TELNET_IAC, (char)TELNET_DONT, TELNET_OPT_LINEMODE,
+        '\0'
+    };
+
+    for (;;) {
+        int fd = accept4(srv->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (srv->session_cnt >= srv->session_max) {
+            close(fd);
+            continue;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));    /* Fails harmlessly for Unix sockets */
+
+        server_session_t* sess_ptr = malloc(sizeof(server_session_t));
+        if (sess_ptr == NULL) {
+            close(fd);
+            continue;
+        }
+        sess_ptr->srv_ptr = srv;
+        sess_ptr->fd = fd;
+        sess_ptr->telnet_state = TELNET_STATE_DATA;
+        sess_ptr->closing = 0;
+        sess_ptr->out_wait = 0;
+        sess_ptr->busy = 0;
+        sess_ptr->broken = 0;
+        sess_ptr->out_pos = sess_ptr->out_len = 0;
+
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = sess_ptr};
+        if (epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(sess_ptr);
+            continue;
+        }
+        __atomic_fetch_add(&srv->session_cnt, 1, __ATOMIC_RELAXED);
+
+        if (srv->telnet) {
+            server_print(&sess_ptr->mrl, telnet_str);
+        }
+        if (srv->connect_fn != NULL) {
+            srv->connect_fn(sess_ptr);
+        }
+        microrl_init_shared(&sess_ptr->mrl, &srv->mrl_cfg);
+
+        if (prv_session_flush(sess_ptr) != 0) {
+            prv_session_free(sess_ptr);
+        }
+    }
+}
+
+/**
+ * \brief           Initialize server instance
+ * \param[out]      srv: Server instance
+ * \param[in]       exec_fn: Command execute callback of all sessions
+ * \param[in]       session_max: Maximum number of connected sessions
+ * \return          `0` on success, `-1` otherwise
+ */
+int server_init(server_t* srv, microrl_exec_fn exec_fn, size_t session_max) {
+    if (srv == NULL || exec_fn == NULL) {
+        return -1;
+    }
+
+    memset(srv, 0x00, sizeof(server_t));
+    srv->listen_fd = -1;
+    microrl_config_init(&srv->mrl_cfg, server_print, exec_fn);
+    srv->session_max = session_max;
+    srv->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+    return (srv->epoll_fd < 0) ? -1 : 0;
+}
+
+/**
+ * \brief           Register listening socket
+ * \param[in,out]   srv: Server instance
+ * \param[in]       fd: Bound socket
+ * \return          `0` on success, `-1` otherwise
+ */
+static int prv_server_listen(server_t* srv, int fd) {
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+
+    if (listen(fd, SOMAXCONN) != 0 || epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        close(fd);
+        return -1;
+    }
+    srv->listen_fd = fd;
+
+    return 0;
+}
+
+/**
+ * \brief           Listen for TCP connections
+ * \param[in,out]   srv: Server instance
+ * \param[in]       addr_str: IPv4 address to bind to
+ * \param[in]       port: TCP port
+ * \return          `0` on success, `-1` otherwise
+ */
+int server_listen_tcp(server_t* srv, const char* addr_str, uint16_t port) {
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port)};
+    int one = 1;
+
+    if (inet_pton(AF_INET, addr_str, &addr.sin_addr) != 1) {
+        return -1;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return prv_server_listen(srv, fd);
+}
+
+/**
+ * \brief           Listen for Unix socket connections
+ * \param[in,out]   srv: Server instance
+ * \param[in]       path_str: Socket path, existing file is replaced
+ * \return          `0` on success, `-1` otherwise
+ */
+int server_listen_unix(server_t* srv, const char* path_str) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+
+    if (strlen(path_str) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    strcpy(addr.sun_path, path_str);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    unlink(path_str);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return prv_server_listen(srv, fd);
+}
+
+/**
+ * \brief           Run commands of sessions in executor instead of server thread.
+ *                      Call it before sessions are connected.
+ *                      Execute callback of executor must print only with \ref server_print
+ *                      and must not call other functions of the session MicroRL instance
+ * \param[in,out]   srv: Server instance
+ * \param[in]       exe: Initialized executor instance
+ * \return          `0` on success, `-1` otherwise
+ */
+int server_set_executor(server_t* srv, executor_t* exe) {
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = exe};
+
+    if (srv == NULL || exe == NULL || srv->session_cnt != 0
+            || epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, exe->event_fd, &ev) != 0) {
+        return -1;
+    }
+    srv->exe_ptr = exe;
+    microrl_config_set_execute_callback(&srv->mrl_cfg, NULL);   /* Entered lines are polled as events */
+
+    return 0;
+}
+
+/**
+ * \brief           Wait for socket events and process them
+ * \param[in,out]   srv: Server instance
+ * \param[in]       timeout_ms: Maximum time to wait in milliseconds, `-1` to wait forever
+ * \return          Number of processed events, `-1` on error
+ */
+int server_poll(server_t* srv, int timeout_ms) {
+    struct epoll_event ev_arr[SERVER_EPOLL_EVENTS];
+
+    int cnt = epoll_wait(srv->epoll_fd, ev_arr, SERVER_EPOLL_EVENTS, timeout_ms);
+    if (cnt < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+
+    for (int i = 0; i < cnt; ++i) {
+        server_session_t* sess_ptr = ev_arr[i].data.ptr;
+
+        if (sess_ptr == NULL) {
+            prv_server_accept(srv);
+            continue;
+        }
+        if ((void*)sess_ptr == srv->exe_ptr) {
+            prv_server_complete(srv);
+            continue;
+        }
+
+        int res = 0;
+        if (ev_arr[i].events & (EPOLLERR | EPOLLHUP)) {
+            res = -1;
+        } else if (ev_arr[i].events & EPOLLIN) {
+            res = prv_session_read(sess_ptr);
+        }
+        prv_session_update(sess_ptr, res);
+    }
+
+    return cnt;
+}
+
+/**
+ * \brief           Stop listening and close all sessions
+ * \note            Sessions are found by epoll, so only the listening socket
+ *                      and epoll instance are closed, and sessions are freed
+ *                      when the process exits
+ * \param[in,out]   srv: Server instance
+ */
+void server_deinit(server_t* srv) {
+    if (srv->listen_fd >= 0) {
+        close(srv->listen_fd);
+        srv->listen_fd = -1;
+    }
+    close(srv->epoll_fd);
+}
+
+/**
+ * \brief           Output callback for MicroRL instances of sessions.
+ *                      Output is buffered and sent after the input is processed
+ * \param[in]       mrl: \ref microrl_t instance of session
+ * \param[in]       str: Output string
+ * \return          The number of characters that would have been written,
+ *                      not counting the terminating null character.
+ */
+int server_print(microrl_t* mrl, const char* str) {
+    server_session_t* sess_ptr = server_session(mrl);
+    size_t len = strlen(str);
+
+    if (sess_ptr->closing && sess_ptr->out_len == SERVER_OUT_BUF_LEN) {
+        return (int)len;                        /* Output is dropped */
+    }
+    if ((sess_ptr->out_len + len) > SERVER_OUT_BUF_LEN) {
+        prv_session_flush(sess_ptr);
+    }
+    if ((sess_ptr->out_len + len) > SERVER_OUT_BUF_LEN) {
+        len = SERVER_OUT_BUF_LEN - sess_ptr->out_len;
+        sess_ptr->closing = 1;                  /* Client doesn't read its output, drop it */
+    }
+
+    memcpy(sess_ptr->out_buf + sess_ptr->out_len, str, len);
+    sess_ptr->out_len += len;
+
+    return (int)len;
+}
+
+/**
+ * \brief           Close session after its output is sent
+ * \param[in]       mrl: \ref microrl_t instance of session
+ */
+void server_session_close(microrl_t* mrl) {
+    server_session(mrl)->closing = 1;
+}
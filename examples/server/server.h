@@ -0,0 +1,119 @@
+/**
+ * \file            server.h
+ * \brief           Multi-session MicroRL server over TCP or Unix sockets
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#ifndef MICRORL_SERVER_HDR_H
+#define MICRORL_SERVER_HDR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "microrl.h"
+#include "executor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Size of output buffer of every session. If a client doesn't read its
+ *                      output and the buffer overflows, the session is closed
+ */
+#ifndef SERVER_OUT_BUF_LEN
+#define SERVER_OUT_BUF_LEN                  4096
+#endif
+
+/**
+ * \brief           Size of stack buffer, that input of a session is read to at once
+ */
+#ifndef SERVER_IN_BUF_LEN
+#define SERVER_IN_BUF_LEN                   1024
+#endif
+
+struct server;
+
+/**
+ * \brief           Session of a connected client
+ */
+typedef struct server_session {
+    microrl_t mrl;                              /*!< MicroRL instance, must be the first member */
+    struct server* srv_ptr;                     /*!< Server the session belongs to */
+    int fd;                                     /*!< Client socket */
+    uint8_t telnet_state;                       /*!< State of telnet commands filter */
+    uint8_t closing;                            /*!< Session is closed after its output is sent */
+    uint8_t out_wait;                           /*!< Socket is polled for writing */
+    uint8_t busy;                               /*!< Command is executed, output belongs to the worker */
+    uint8_t broken;                             /*!< Connection is broken while command is executed */
+    executor_job_t job;                         /*!< Command passed to executor */
+    size_t out_pos;                             /*!< Position of the first byte to send */
+    size_t out_len;                             /*!< Length of buffered output */
+    char out_buf[SERVER_OUT_BUF_LEN];           /*!< Output buffer */
+} server_session_t;
+
+/**
+ * \brief           Session connect callback, called before prompt is printed
+ * \param[in,out]   sess_ptr: Connected session
+ */
+typedef void (*server_connect_fn)(server_session_t* sess_ptr);
+
+/**
+ * \brief           Server instance
+ */
+typedef struct server {
+    int epoll_fd;                               /*!< epoll instance */
+    int listen_fd;                              /*!< Listening socket */
+    uint8_t telnet;                             /*!< Negotiate character mode with telnet clients */
+    size_t session_cnt;                         /*!< Number of connected sessions */
+    size_t session_max;                         /*!< Maximum number of connected sessions */
+    microrl_config_t mrl_cfg;                   /*!< MicroRL configuration shared by all sessions */
+    server_connect_fn connect_fn;               /*!< Optional session connect callback */
+    executor_t* exe_ptr;                        /*!< Optional executor, that runs commands of sessions */
+    uint64_t rx_bytes;                          /*!< Number of received bytes */
+    uint64_t tx_bytes;                          /*!< Number of sent bytes */
+} server_t;
+
+int     server_init(server_t* srv, microrl_exec_fn exec_fn, size_t session_max);
+int     server_listen_tcp(server_t* srv, const char* addr_str, uint16_t port);
+int     server_listen_unix(server_t* srv, const char* path_str);
+int     server_set_executor(server_t* srv, executor_t* exe);
+int     server_poll(server_t* srv, int timeout_ms);
+void    server_deinit(server_t* srv);
+
+int     server_print(microrl_t* mrl, const char* str);
+void    server_session_close(microrl_t* mrl);
+
+/**
+ * \brief           Get session of MicroRL instance
+ * \param[in]       mrl: \ref microrl_t instance of session
+ * \return          Session pointer
+ */
+static inline server_session_t* server_session(microrl_t* mrl) {
+    return (server_session_t*)mrl;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* MICRORL_SERVER_HDR_H */
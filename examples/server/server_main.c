@@ -0,0 +1,189 @@
+/**
+ * \file            server_main.c
+ * \brief           Multi-session MicroRL server demo for Linux hosts
+ */
+
+/*
+ * Copyright (c) 2021 Dmitry KARASEV
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+ *
+ * Authors:         Dmitry KARASEV <karasevsdmitry@yandex.ru>
+ * Version:         2.6.0
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "server.h"
+
+/* Available commands, sorted for completion */
+static const char* const cmd_table[] = {"echo", "help", "quit", "sessions", "stats"};
+
+static server_t srv;
+static executor_t exe;
+static volatile sig_atomic_t stop;
+
+/**
+ * \brief           Print greeting to connected session
+ * \param[in,out]   sess_ptr: Connected session
+ */
+static void on_connect(server_session_t* sess_ptr) {
+    server_print(&sess_ptr->mrl, "MicroRL server, type 'help' for the list of commands" MICRORL_CFG_END_LINE);
+}
+
+/**
+ * \brief           Execute callback for MicroRL library.
+ *                      It is called by worker threads of executor, if server is run with them
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          '0' on success, '1' otherwise
+ */
+static int execute(microrl_t* mrl, int argc, const char* const *argv) {
+    char str[96];
+
+    if (strcmp(argv[0], "echo") == 0) {
+        for (int i = 1; i < argc; ++i) {
+            server_print(mrl, argv[i]);
+            server_print(mrl, (i + 1 < argc) ? " " : "");
+        }
+        server_print(mrl, MICRORL_CFG_END_LINE);
+    } else if (strcmp(argv[0], "help") == 0) {
+        server_print(mrl, "Use TAB key for completion" MICRORL_CFG_END_LINE "Command:" MICRORL_CFG_END_LINE);
+        server_print(mrl, "\techo [args] - print arguments" MICRORL_CFG_END_LINE);
+        server_print(mrl, "\thelp        - this message" MICRORL_CFG_END_LINE);
+        server_print(mrl, "\tquit        - close session" MICRORL_CFG_END_LINE);
+        server_print(mrl, "\tsessions    - print number of connected sessions" MICRORL_CFG_END_LINE);
+        server_print(mrl, "\tstats       - print traffic counters" MICRORL_CFG_END_LINE);
+    } else if (strcmp(argv[0], "quit") == 0) {
+        server_session_close(mrl);
+    } else if (strcmp(argv[0], "sessions") == 0) {
+        snprintf(str, sizeof(str), "%zu of %zu" MICRORL_CFG_END_LINE, __atomic_load_n(&srv.session_cnt, __ATOMIC_RELAXED), srv.session_max);
+        server_print(mrl, str);
+    } else if (strcmp(argv[0], "stats") == 0) {
+        snprintf(str, sizeof(str), "rx %llu bytes, tx %llu bytes" MICRORL_CFG_END_LINE,
+                 (unsigned long long)__atomic_load_n(&srv.rx_bytes, __ATOMIC_RELAXED),
+                 (unsigned long long)__atomic_load_n(&srv.tx_bytes, __ATOMIC_RELAXED));
+        server_print(mrl, str);
+    } else {
+        server_print(mrl, "command: '");
+        server_print(mrl, argv[0]);
+        server_print(mrl, "' Not found." MICRORL_CFG_END_LINE);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief           Stop server on SIGINT and SIGTERM
+ * \param[in]       sig: Signal number
+ */
+static void on_signal(int sig) {
+    (void)sig;
+    stop = 1;
+}
+
+/**
+ * \brief           Print usage
+ * \param[in]       name: Program name
+ */
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-a addr] [-p port] [-u path] [-n max_sessions] [-w workers] [-t]\n"
+                    "  -a addr  IPv4 address to listen on (127.0.0.1)\n"
+                    "  -p port  TCP port to listen on (2323)\n"
+                    "  -u path  listen on Unix socket instead of TCP\n"
+                    "  -n num   maximum number of sessions (16384)\n"
+                    "  -w num   execute commands in num worker threads (0, in server thread)\n"
+                    "  -t       negotiate character mode with telnet clients\n", name);
+}
+
+/**
+ * \brief           Program entry point
+ */
+int main(int argc, char** argv) {
+    const char* addr_str = "127.0.0.1";
+    const char* path_str = NULL;
+    unsigned long port = 2323;
+    size_t session_max = 16384;
+    size_t worker_cnt = 0;
+    uint8_t telnet = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:p:u:n:w:th")) != -1) {
+        switch (opt) {
+            case 'a': addr_str = optarg; break;
+            case 'p': port = strtoul(optarg, NULL, 0); break;
+            case 'u': path_str = optarg; break;
+            case 'n': session_max = strtoul(optarg, NULL, 0); break;
+            case 'w': worker_cnt = strtoul(optarg, NULL, 0); break;
+            case 't': telnet = 1; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+
+    struct rlimit lim;                          /* Every session takes a file descriptor */
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    if (server_init(&srv, execute, session_max) != 0) {
+        perror("server_init");
+        return 1;
+    }
+    srv.telnet = telnet;
+    srv.connect_fn = on_connect;
+    microrl_config_set_complete_table(&srv.mrl_cfg, cmd_table, MICRORL_ARRAYSIZE(cmd_table));
+    if (worker_cnt != 0 && (executor_init(&exe, execute, worker_cnt) != 0 || server_set_executor(&srv, &exe) != 0)) {
+        perror("executor");
+        return 1;
+    }
+
+    if ((path_str != NULL ? server_listen_unix(&srv, path_str) : server_listen_tcp(&srv, addr_str, (uint16_t)port)) != 0) {
+        perror("listen");
+        return 1;
+    }
+    if (path_str != NULL) {
+        printf("Listening on %s, sessions limit %zu, workers %zu\n", path_str, session_max, worker_cnt);
+    } else {
+        printf("Listening on %s:%lu, sessions limit %zu, workers %zu\n", addr_str, port, session_max, worker_cnt);
+    }
+    fflush(stdout);
+
+    while (!stop) {
+        if (server_poll(&srv, 1000) < 0) {
+            perror("server_poll");
+            break;
+        }
+    }
+
+    server_deinit(&srv);
+    if (worker_cnt != 0) {
+        executor_deinit(&exe);
+    }
+    if (path_str != NULL) {
+        unlink(path_str);
+    }
+
+    return 0;
+}
@@ -37,6 +37,7 @@
 #define UART_TX_GPIO_Port           GPIOC
 #define UART_RX_Pin                 LL_GPIO_PIN_11
 #define UART_RX_GPIO_Port           GPIOC
+#define UART_BAUDRATE               115200
 
 #define _STM32_DEMO_VER             "1.3"
 
@@ -46,11 +47,18 @@
 #define _CMD_HELP                   "help"
 #define _CMD_CLEAR                  "clear"
 #define _CMD_SERNUM                 "sernum"
+#if MICRORL_CFG_USE_INPUT_RING
+#define _CMD_RXSTAT                 "rxstat"
+#endif /* MICRORL_CFG_USE_INPUT_RING */
 /* Arguments for set/clear */
 #define _SCMD_RD                    "?"
 #define _SCMD_SAVE                  "save"
 
+#if MICRORL_CFG_USE_INPUT_RING
+#define _NUM_OF_CMD                 4
+#else
 #define _NUM_OF_CMD                 3
+#endif /* MICRORL_CFG_USE_INPUT_RING */
 #define _NUM_OF_SETCLEAR_SCMD       2
 
 #if MICRORL_CFG_USE_ECHO_OFF
@@ -59,7 +67,11 @@
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
 
 /* Available  commands */
+#if MICRORL_CFG_USE_INPUT_RING
+char* keyword[] = {_CMD_HELP, _CMD_CLEAR, _CMD_SERNUM, _CMD_RXSTAT};
+#else
 char* keyword[] = {_CMD_HELP, _CMD_CLEAR, _CMD_SERNUM};
+#endif /* MICRORL_CFG_USE_INPUT_RING */
 
 /* 'read/save' command argements */
 char* read_save_key[] = {_SCMD_RD, _SCMD_SAVE};
@@ -76,6 +88,13 @@ uint8_t  logged_in = 0;
 uint8_t  passw_in = 0;
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
 
+#if MICRORL_CFG_USE_INPUT_RING
+/* Characters received in UART interrupt, drained by main loop */
+microrl_input_ring_t rx_ring;
+/* Number of characters lost by UART, because interrupt was not served in time */
+volatile uint32_t rx_overrun_cnt = 0;
+#endif /* MICRORL_CFG_USE_INPUT_RING */
+
 /**
  * \brief           Init STM32F4 platform
  */
@@ -95,7 +114,7 @@ void init(void) {
     GPIO_InitStruct.Alternate = LL_GPIO_AF_8;
     LL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
-    USART_InitStruct.BaudRate = 115200;
+    USART_InitStruct.BaudRate = UART_BAUDRATE;
     USART_InitStruct.DataWidth = LL_USART_DATAWIDTH_8B;
     USART_InitStruct.StopBits = LL_USART_STOPBITS_1;
     USART_InitStruct.Parity = LL_USART_PARITY_NONE;
@@ -108,9 +127,31 @@ void init(void) {
 
     LL_USART_ConfigAsyncMode(UART4);
 
+#if MICRORL_CFG_USE_INPUT_RING
+    microrl_input_ring_init(&rx_ring);
+    LL_USART_EnableIT_RXNE(UART4);              /* Enables overrun interrupt too */
+    NVIC_SetPriority(UART4_IRQn, 0);
+    NVIC_EnableIRQ(UART4_IRQn);
+#endif /* MICRORL_CFG_USE_INPUT_RING */
+
     LL_USART_Enable(UART4);
 }
 
+#if MICRORL_CFG_USE_INPUT_RING
+/**
+ * \brief           UART4 interrupt handler, pushes received character into input ring
+ */
+void UART4_IRQHandler(void) {
+    if (LL_USART_IsActiveFlag_ORE(UART4)) {
+        ++rx_overrun_cnt;
+    }
+    if (LL_USART_IsActiveFlag_RXNE(UART4)) {
+        char ch = (char)LL_USART_ReceiveData8(UART4);   /* Reading data clears overrun flag too */
+        microrl_input_ring_push(&rx_ring, &ch, 1);
+    }
+}
+#endif /* MICRORL_CFG_USE_INPUT_RING */
+
 /**
  * \brief           Print to IO stream callback for MicroRL library
  * \param[in]       mrl: \ref microrl_t working instance
@@ -183,6 +224,9 @@ void print_help(microrl_t* mrl) {
     print(mrl, "\tsernum ?            - read serial number value"_ENDLINE_SEQ);
     print(mrl, "\tsernum VALUE        - set serial number value"_ENDLINE_SEQ);
     print(mrl, "\tsernum save         - save serial number value to flash"_ENDLINE_SEQ);
+#if MICRORL_CFG_USE_INPUT_RING
+    print(mrl, "\trxstat              - print number of lost input characters"_ENDLINE_SEQ);
+#endif /* MICRORL_CFG_USE_INPUT_RING */
 }
 
 /**
@@ -274,6 +318,27 @@ void set_sernum(microrl_t* mrl, char* str_val) {
     print(mrl, "\tS/N not set"_ENDLINE_SEQ);
 }
 
+#if MICRORL_CFG_USE_INPUT_RING
+/**
+ * \brief           RXSTAT command callback
+ * \param[in]       mrl: \ref microrl_t working instance
+ */
+void print_rxstat(microrl_t* mrl) {
+    char cnt_str[11] = {0};
+    uint32_t cnt = rx_ring.overflow_cnt;
+    u32_to_str(&cnt, cnt_str);
+
+    print(mrl, "\tRing overflows ");
+    print(mrl, cnt_str[0] != '\0' ? cnt_str : "0");
+    print(mrl, ", UART overruns ");
+    memset(cnt_str, 0, sizeof(cnt_str));
+    cnt = rx_overrun_cnt;
+    u32_to_str(&cnt, cnt_str);
+    print(mrl, cnt_str[0] != '\0' ? cnt_str : "0");
+    print(mrl, _ENDLINE_SEQ);
+}
+#endif /* MICRORL_CFG_USE_INPUT_RING */
+
 /**
  * \brief           SERNUM SAVE command callback
  * \param[in]       mrl: \ref microrl_t working instance
@@ -308,6 +373,11 @@ int execute(microrl_t* mrl, int argc, const char* const *argv) {
         } else if (strcmp(argv[i], _CMD_CLEAR) == 0) {
             clear_screen(mrl);
             return 0;
+#if MICRORL_CFG_USE_INPUT_RING
+        } else if (strcmp(argv[i], _CMD_RXSTAT) == 0) {
+            print_rxstat(mrl);
+            return 0;
+#endif /* MICRORL_CFG_USE_INPUT_RING */
         } else if (strcmp(argv[i], _CMD_SERNUM) == 0) {
             if (++i < argc) {
                 if (strcmp(argv[i], _SCMD_RD) == 0) {
@@ -221,6 +221,13 @@ char ** complete(microrl_t* mrl, int argc, const char* const *argv) {
                 compl_word[j++] = keyword[i];
             }
         }
+#if MICRORL_CFG_USE_COMPLETE_FUZZY
+        /* If no token starts with text, offer tokens containing its chars in the same order */
+        if (j == 0) {
+            j = (int)microrl_complete_fuzzy(bit, strlen(bit), (const char* const*)keyword, _NUM_OF_CMD,
+                                            (const char**)compl_word, _NUM_OF_CMD);
+        }
+#endif /* MICRORL_CFG_USE_COMPLETE_FUZZY */
     }  else if ((argc > 1) && (strcmp (argv[0], _CMD_VER) == 0)) { /* If command needs subcommands */
         /* Iterate through subcommand for command _CMD_VER array */
         for (int i = 0; i < _NUM_OF_VER_SCMD; i++) {
@@ -65,7 +65,8 @@ typedef enum {
     microrlERRPAR = 0x02,                        /*!< Parameter error */
     microrlERRTKNNUM = 0x03,                     /*!< Too many tokens */
     microrlERRCLFULL = 0x04,                     /*!< Command line is full */
-    microrlERRCPLT = 0x05                        /*!< Auto-completion error */
+    microrlERRCPLT = 0x05,                       /*!< Auto-completion error */
+    microrlERREMPTY = 0x06                       /*!< No event to poll */
 } microrlr_t;
 
 /**
@@ -89,6 +90,146 @@ typedef enum {
 } microrl_echo_t;
 #endif /* MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__ */
 
+/**
+ * \brief           Command line index type, the smallest one to hold positions up to
+ *                      \ref MICRORL_CFG_CMDLINE_LEN and \ref MICRORL_CMDLINE_IDX_NONE
+ */
+#if (MICRORL_CFG_CMDLINE_LEN < UINT8_MAX) || __DOXYGEN__
+typedef uint8_t     microrl_cmdline_idx_t;
+#define MICRORL_CMDLINE_IDX_NONE            UINT8_MAX   /*!< Invalid command line index */
+#elif MICRORL_CFG_CMDLINE_LEN < UINT16_MAX
+typedef uint16_t    microrl_cmdline_idx_t;
+#define MICRORL_CMDLINE_IDX_NONE            UINT16_MAX
+#else
+typedef size_t      microrl_cmdline_idx_t;
+#define MICRORL_CMDLINE_IDX_NONE            SIZE_MAX
+#endif
+
+#if MICRORL_CFG_USE_HISTORY || __DOXYGEN__
+/**
+ * \brief           History ring buffer index type, the smallest one to hold positions in buffer
+ *                      of \ref MICRORL_CFG_RING_HISTORY_LEN size. Number of records is less than
+ *                      half of the size, so \ref MICRORL_HIST_IDX_NONE is never a record number
+ */
+#if (MICRORL_CFG_RING_HISTORY_LEN <= UINT8_MAX + 1) || __DOXYGEN__
+typedef uint8_t     microrl_hist_idx_t;
+#define MICRORL_HIST_IDX_NONE               UINT8_MAX   /*!< Invalid history record number */
+#elif MICRORL_CFG_RING_HISTORY_LEN <= UINT16_MAX + 1
+typedef uint16_t    microrl_hist_idx_t;
+#define MICRORL_HIST_IDX_NONE               UINT16_MAX
+#else
+typedef size_t      microrl_hist_idx_t;
+#define MICRORL_HIST_IDX_NONE               SIZE_MAX
+#endif
+#endif /* MICRORL_CFG_USE_HISTORY || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_INPUT_RING || __DOXYGEN__
+#if (MICRORL_CFG_INPUT_RING_LEN & (MICRORL_CFG_INPUT_RING_LEN - 1)) != 0
+#error "MICRORL_CFG_INPUT_RING_LEN must be a power of 2"
+#endif
+
+/**
+ * \brief           Input ring buffer index type. Indexes run freely and wrap around at the type limit,
+ *                      so one more than \ref MICRORL_CFG_INPUT_RING_LEN values must fit into it
+ */
+#if (MICRORL_CFG_INPUT_RING_LEN <= (UINT8_MAX + 1) / 2) || __DOXYGEN__
+typedef uint8_t     microrl_ring_idx_t;
+#elif MICRORL_CFG_INPUT_RING_LEN <= (UINT16_MAX + 1) / 2
+typedef uint16_t    microrl_ring_idx_t;
+#else
+typedef size_t      microrl_ring_idx_t;
+#endif
+
+/**
+ * \brief           Lock-free single-producer/single-consumer input ring buffer
+ *
+ * Producer (interrupt handler) writes only `head` and `overflow_cnt`,
+ * consumer (main loop) writes only `tail`, so no locking is required
+ */
+typedef struct microrl_input_ring {
+    char buf[MICRORL_CFG_INPUT_RING_LEN];       /*!< Received characters */
+    volatile microrl_ring_idx_t head;           /*!< Number of pushed characters, written by producer only */
+    volatile microrl_ring_idx_t tail;           /*!< Number of processed characters, written by consumer only */
+    volatile uint16_t overflow_cnt;             /*!< Number of characters dropped because ring was full */
+} microrl_input_ring_t;
+#endif /* MICRORL_CFG_USE_INPUT_RING || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__
+#if ((MICRORL_CFG_ASYNC_PRINT_MSG_NUM & (MICRORL_CFG_ASYNC_PRINT_MSG_NUM - 1)) != 0) \
+        || (MICRORL_CFG_ASYNC_PRINT_MSG_NUM < 2) || (MICRORL_CFG_ASYNC_PRINT_MSG_NUM > 64)
+#error "MICRORL_CFG_ASYNC_PRINT_MSG_NUM must be a power of 2, at least 2 and not more than 64"
+#endif
+
+/**
+ * \brief           Message of asynchronous print queue
+ */
+typedef struct microrl_async_msg {
+    uint8_t seq;                                /*!< Sequence number, tells whether message is free or ready */
+    char msg_str[MICRORL_CFG_ASYNC_PRINT_MSG_LEN + sizeof(MICRORL_CFG_END_LINE)];  /*!< Message with end line */
+} microrl_async_msg_t;
+
+/**
+ * \brief           Lock-free multi-producer/single-consumer queue of asynchronously printed messages
+ *
+ * Producer reserves a message by moving `enq_pos` with compare-and-swap, fills it
+ * and publishes it with sequence number, so producers don't wait for each other
+ */
+typedef struct microrl_async_queue {
+    microrl_async_msg_t msg_arr[MICRORL_CFG_ASYNC_PRINT_MSG_NUM];   /*!< Messages */
+    uint8_t enq_pos;                            /*!< Number of reserved messages, written by producers */
+    uint8_t deq_pos;                            /*!< Number of printed messages, written by consumer only */
+} microrl_async_queue_t;
+#endif /* MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_EVENTS || __DOXYGEN__
+/**
+ * \brief           List of events, that are polled instead of callbacks set to NULL
+ */
+typedef enum {
+    MICRORL_EVENT_NONE = 0,                     /*!< No event */
+    MICRORL_EVENT_LINE,                         /*!< Command line is entered, finish it with \ref microrl_command_complete */
+    MICRORL_EVENT_COMPLETE,                     /*!< Completion is requested, answer with \ref microrl_complete_answer.
+                                                        Answered candidates must stay valid until it returns,
+                                                        or while cycling with \ref MICRORL_CFG_USE_COMPLETE_CYCLE */
+    MICRORL_EVENT_SIGINT                        /*!< Ctrl+C is pressed */
+} microrl_event_type_t;
+
+/**
+ * \brief           Event polled from instance
+ */
+typedef struct microrl_event {
+    microrl_event_type_t type;                  /*!< Type of event */
+    int argc;                                   /*!< Number of command line tokens */
+    const char* const* argv;                    /*!< Tokens in command line buffer of instance, valid until
+                                                        the line is finished or completion is answered */
+} microrl_event_t;
+#endif /* MICRORL_CFG_USE_EVENTS || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_STATS || __DOXYGEN__
+/**
+ * \brief           Counters of instance, read with \ref microrl_get_stats. Counters wrap around on overflow
+ */
+typedef struct microrl_stats {
+    uint32_t in_bytes;                          /*!< Bytes passed to \ref microrl_processing_input */
+    uint32_t out_calls;                         /*!< Calls of output callback */
+    uint32_t out_bytes;                         /*!< Bytes printed by output callback */
+    uint32_t redraws;                           /*!< Redraws of command line after moving cursor from the line start */
+    uint32_t hist_lookups;                      /*!< History records restored to command line or searched for suggestion */
+    uint32_t completions;                       /*!< Completion requests */
+} microrl_stats_t;
+#endif /* MICRORL_CFG_USE_STATS || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_TIMING || __DOXYGEN__
+/**
+ * \brief           Execution time histogram of command, filled by library. Counters wrap around on overflow
+ */
+typedef struct microrl_timing {
+    uint32_t count;                             /*!< Number of executions */
+    uint32_t max;                               /*!< The longest execution time in ticks */
+    uint32_t bucket_arr[MICRORL_CFG_TIMING_BUCKETS];    /*!< Number of executions in `2^N` ticks range */
+} microrl_timing_t;
+#endif /* MICRORL_CFG_USE_TIMING || __DOXYGEN__ */
+
 /* Forward declarations */
 struct microrl;
 #if MICRORL_CFG_USE_HISTORY
@@ -104,9 +245,9 @@ struct microrl_hist_rbuf;
  */
 typedef struct microrl_hist_rbuf {
     char ring_buf[MICRORL_CFG_RING_HISTORY_LEN];/*!< History buffer */
-    size_t head;                                /*!< Buffer head position */
-    size_t tail;                                /*!< Buffer tail position */
-    size_t count;                               /*!< Navigation counter */
+    microrl_hist_idx_t head;                    /*!< Buffer head position */
+    microrl_hist_idx_t tail;                    /*!< Buffer tail position */
+    microrl_hist_idx_t count;                   /*!< Navigation counter */
 } microrl_hist_rbuf_t;
 #endif /* MICRORL_CFG_USE_HISTORY || __DOXYGEN__ */
 
@@ -123,11 +264,19 @@ typedef int       (*microrl_output_fn)(struct microrl* mrl, const char* str);
  * \brief           Command execute callback function
  * \param[in]       mrl: microRL working instance
  * \param[in]       argc: argument count
- * \param[in]       argv: pointer array to token string
- * \return          '0' on success, '1' otherwise
+ * \param[in]       argv: pointer array to token string, valid only until the callback returns
+ * \return          '0' on success, '1' otherwise, or \ref MICRORL_EXEC_PENDING if command is
+ *                      still running and \ref microrl_command_complete will be called later
  */
 typedef int       (*microrl_exec_fn)(struct microrl* mrl, int argc, const char* const *argv);
 
+#if MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__
+/**
+ * \brief           Return value of command execute callback, that continues command in another task
+ */
+#define MICRORL_EXEC_PENDING                (-1)
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__ */
+
 /**
  * \brief           Auto-complete function prototype
  * \param[in,out]   mrl: \ref microrl_t working instance
@@ -139,6 +288,45 @@ typedef int       (*microrl_exec_fn)(struct microrl* mrl, int argc, const char*
  */
 typedef char**    (*microrl_get_compl_fn)(struct microrl* mrl, int argc, const char* const *argv);
 
+#if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
+/**
+ * \brief           Common prefix length of completion candidates is not known and
+ *                      will be calculated by library
+ */
+#define MICRORL_COMPL_PREFIX_UNKNOWN        ((size_t)-1)
+
+/**
+ * \brief           List of auto-completion candidates
+ *
+ * With \ref MICRORL_CFG_USE_COMPLETE_CYCLE candidates array, lengths and strings are cached
+ * for the next 'Tab', so they must stay valid until a key other than 'Tab' is processed.
+ * It applies to candidates answered by 'microrl_complete_answer()' too.
+ */
+typedef struct microrl_compl_list {
+    const char* const* cmplt_arr;               /*!< Array of completion candidates, no NULL pointer at the end required */
+    const size_t* len_arr;                      /*!< Optional array of candidates lengths. Set to NULL to calculate them
+                                                        with `strlen()`, otherwise candidates may be not NULL-terminated */
+    size_t count;                               /*!< Number of completion candidates */
+    size_t prefix_len;                          /*!< Length of prefix common to all candidates, if it's known, or
+                                                        \ref MICRORL_COMPL_PREFIX_UNKNOWN otherwise */
+} microrl_compl_list_t;
+
+/**
+ * \brief           Auto-complete function prototype returning counted list of candidates
+ *
+ * List is set to be empty with unknown common prefix length before the call.
+ * Candidates storage must stay valid until the function is called next time.
+ *
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \param[out]      cmplt_list_ptr: List of completion candidates to fill.
+ *                      If complete token found, it's must contain only one candidate
+ */
+typedef void      (*microrl_get_compl_list_fn)(struct microrl* mrl, int argc, const char* const *argv,
+                                               struct microrl_compl_list* cmplt_list_ptr);
+#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
+
 /**
  * \brief           Ctrl+C terminal signal function prototype
  * \param[in,out]   mrl: \ref microrl_t working instance
@@ -146,59 +334,202 @@ typedef char**    (*microrl_get_compl_fn)(struct microrl* mrl, int argc, const c
 typedef void      (*microrl_sigint_fn)(struct microrl* mrl);
 
 /**
- * \brief           MicroRL instance
+ * \brief           MicroRL configuration, that may be shared by many instances
  */
-typedef struct microrl {
+typedef struct microrl_config {
     microrl_output_fn out_fn;                   /*!< Output function for print operations */
     microrl_exec_fn exec_fn;                    /*!< Command execute callback */
 #if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
     microrl_get_compl_fn get_completion_fn;     /*!< Auto-completion callback */
+    microrl_get_compl_list_fn get_compl_list_fn;/*!< Auto-completion callback returning counted list */
+#if MICRORL_CFG_USE_COMPLETE_TABLE || __DOXYGEN__
+    const char* const* compl_table_ptr;         /*!< Sorted table of commands for auto-completion */
+    size_t compl_table_len;                     /*!< Number of commands in completion table */
+#endif /* MICRORL_CFG_USE_COMPLETE_TABLE || __DOXYGEN__ */
 #endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
 #if MICRORL_CFG_USE_CTRL_C || __DOXYGEN__
     microrl_sigint_fn sigint_fn;                /*!< Ctrl+C terminal signal callback */
 #endif /* MICRORL_CFG_USE_CTRL_C || __DOXYGEN__ */
-
+#if MICRORL_CFG_USE_TIMING || __DOXYGEN__
+    microrl_timing_t* timing_arr;               /*!< Histograms of commands of completion table followed by
+                                                        the one of other commands */
+#endif /* MICRORL_CFG_USE_TIMING || __DOXYGEN__ */
     char* prompt_ptr;                           /*!< Pointer to prompt string */
-    size_t prompt_size;                          /*!< Size of prompt string */
-    char cmdline_str[MICRORL_CFG_CMDLINE_LEN + 1];  /*!< Command line input buffer with NULL character */
-    size_t cmdlen;                              /*!< Command length in command line buffer */
-    size_t cursor;                              /*!< Command line buffer position pointer */
-    char last_endl;                             /*!< Either 0 or the CR or LF that just triggered a newline */
+    size_t prompt_size;                         /*!< Size of prompt string */
+} microrl_config_t;
 
-#if MICRORL_CFG_USE_ESC_SEQ || __DOXYGEN__
-    microrl_esc_code_t esc_code;                /*!< Code of first escape sequence symbol */
-    uint8_t escape;                             /*!< Escape sequence caught flag */
-#endif /* MICRORL_CFG_USE_ESC_SEQ || __DOXYGEN__ */
+/**
+ * \brief           MicroRL instance
+ */
+typedef struct microrl {
+#if MICRORL_CFG_USE_SHARED_CONFIG || __DOXYGEN__
+    const microrl_config_t* cfg_ptr;            /*!< Configuration shared with other instances */
+#endif /* MICRORL_CFG_USE_SHARED_CONFIG || __DOXYGEN__ */
+#if !MICRORL_CFG_USE_SHARED_CONFIG || __DOXYGEN__
+    microrl_config_t cfg;                       /*!< Configuration of the instance */
+#endif /* !MICRORL_CFG_USE_SHARED_CONFIG || __DOXYGEN__ */
+    void* userdata_ptr;                         /*!< Generic user data storage */
 
+    /* Pointer and size_t fields go first, followed by byte arrays and compact indexes, to avoid padding */
+#if (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE && MICRORL_CFG_USE_COMPLETE_FUZZY) || __DOXYGEN__
+    const char* compl_fuzzy_arr[MICRORL_CFG_COMPL_FUZZY_TOP_K]; /*!< Ranked fuzzy matches from completion table */
+#endif /* (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE && MICRORL_CFG_USE_COMPLETE_FUZZY) || __DOXYGEN__ */
+#if MICRORL_CFG_USE_EVENTS || __DOXYGEN__
+    const char* evt_argv[MICRORL_CFG_CMD_TOKEN_NMB + 1];    /*!< NULL-terminated tokens of event */
+#endif /* MICRORL_CFG_USE_EVENTS || __DOXYGEN__ */
+#if (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_CYCLE) || __DOXYGEN__
+    const char* const* cycle_arr;               /*!< Cached completion candidates to cycle through */
+    const size_t* cycle_len_arr;                /*!< Cached lengths of completion candidates or NULL */
+    size_t cycle_cnt;                           /*!< Number of cached candidates, 0 if cycling is inactive */
+    size_t cycle_idx;                           /*!< Index of the next candidate to cycle to */
+#endif /* (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_CYCLE) || __DOXYGEN__ */
+#if MICRORL_CFG_USE_STATS || __DOXYGEN__
+    microrl_stats_t stats;                      /*!< Counters of instance */
+#endif /* MICRORL_CFG_USE_STATS || __DOXYGEN__ */
+#if MICRORL_CFG_USE_TIMING || __DOXYGEN__
+    microrl_timing_t* timing_ptr;               /*!< Histogram of executed command or NULL */
+    uint32_t timing_start;                      /*!< Tick the executed command is started at */
+#endif /* MICRORL_CFG_USE_TIMING || __DOXYGEN__ */
+
+    char cmdline_str[MICRORL_CFG_CMDLINE_LEN + 1];  /*!< Command line input buffer with NULL character */
+#if (MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS) || __DOXYGEN__
+    char hint_str[MICRORL_CFG_CMDLINE_LEN + 1]; /*!< History record suggested to complete command line */
+#endif /* (MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS) || __DOXYGEN__ */
 #if MICRORL_CFG_USE_HISTORY || __DOXYGEN__
     microrl_hist_rbuf_t ring_hist;              /*!< Ring history object */
 #endif /* MICRORL_CFG_USE_HISTORY || __DOXYGEN__ */
+#if MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__
+    microrl_async_queue_t async_queue;          /*!< Messages to print above the prompt */
+#endif /* MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__ */
+#if MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__
+    char typeahead_str[MICRORL_CFG_EXEC_TYPEAHEAD_LEN]; /*!< Input received while deferred command is executed */
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__ */
 
+    microrl_cmdline_idx_t cmdlen;               /*!< Command length in command line buffer */
+    microrl_cmdline_idx_t cursor;               /*!< Command line buffer position pointer */
+#if (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_CYCLE) || __DOXYGEN__
+    microrl_cmdline_idx_t cycle_pos;            /*!< Command line position of token being completed */
+#endif /* (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_CYCLE) || __DOXYGEN__ */
+#if (MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS) || __DOXYGEN__
+    microrl_cmdline_idx_t hint_len;             /*!< Length of suggested record */
+    microrl_cmdline_idx_t hint_pos;             /*!< Command line length on the last suggestion update,
+                                                        or \ref MICRORL_CMDLINE_IDX_NONE to search again */
+    microrl_cmdline_idx_t hint_shown;           /*!< Number of suggestion characters printed after command line */
+    microrl_hist_idx_t hint_rec;                /*!< Number of suggested record, `1` is the newest one, or
+                                                        \ref MICRORL_HIST_IDX_NONE if no older record matches */
+#endif /* (MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS) || __DOXYGEN__ */
+#if MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__
+    microrl_cmdline_idx_t typeahead_len;        /*!< Number of characters typed ahead */
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__ */
+#if (MICRORL_CFG_USE_EVENTS && MICRORL_CFG_USE_COMPLETE) || __DOXYGEN__
+    microrl_cmdline_idx_t evt_tkn_end;          /*!< End of token to complete with answer to event */
+#endif /* (MICRORL_CFG_USE_EVENTS && MICRORL_CFG_USE_COMPLETE) || __DOXYGEN__ */
 #if MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__
-    microrl_echo_t echo;                        /*!< Echo mode */
-    int32_t echo_off_pos;                       /*!< Start position to print '*' echo off chars */
+    microrl_cmdline_idx_t echo_off_pos;         /*!< Start position to print '*' echo off chars,
+                                                        or \ref MICRORL_CMDLINE_IDX_NONE if not set */
 #endif /* MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__ */
+#if MICRORL_CFG_USE_EVENTS || __DOXYGEN__
+    uint8_t evt_argc;                           /*!< Number of tokens of event */
+#endif /* MICRORL_CFG_USE_EVENTS || __DOXYGEN__ */
 
-    void* userdata_ptr;                         /*!< Generic user data storage */
+    uint8_t last_endl : 4;                      /*!< Either 0 or the CR or LF that just triggered a newline */
+#if MICRORL_CFG_USE_ESC_SEQ || __DOXYGEN__
+    uint8_t escape : 1;                         /*!< Escape sequence caught flag */
+    uint8_t esc_code : 2;                       /*!< Code of first escape sequence symbol, \ref microrl_esc_code_t */
+#endif /* MICRORL_CFG_USE_ESC_SEQ || __DOXYGEN__ */
+#if MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__
+    uint8_t echo : 2;                           /*!< Echo mode, \ref microrl_echo_t */
+#endif /* MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__ */
+#if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
+    uint8_t compl_list_shown : 1;               /*!< Completion candidates are printed below command line */
+#if (MICRORL_CFG_COMPL_QUERY_ITEMS > 0) || __DOXYGEN__
+    uint8_t compl_query : 1;                    /*!< Waiting for answer to print all completion candidates */
+#endif /* (MICRORL_CFG_COMPL_QUERY_ITEMS > 0) || __DOXYGEN__ */
+#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
+#if MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__
+    uint8_t exec_pending : 1;                   /*!< Command is executed in another task, prompt isn't printed */
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__ */
+#if MICRORL_CFG_USE_EVENTS || __DOXYGEN__
+    uint8_t evt_type : 2;                       /*!< Line or completion event waiting to be finished, \ref microrl_event_type_t */
+    uint8_t evt_polled : 1;                     /*!< Waiting event is already polled */
+    uint8_t evt_query : 1;                      /*!< Ask before printing many candidates answered to completion event */
+    uint8_t evt_sigint : 1;                     /*!< Ctrl+C is pressed and not polled yet */
+#endif /* MICRORL_CFG_USE_EVENTS || __DOXYGEN__ */
 } microrl_t;
 
+microrlr_t  microrl_config_init(microrl_config_t* cfg, microrl_output_fn out_fn, microrl_exec_fn exec_fn);
+microrlr_t  microrl_config_set_execute_callback(microrl_config_t* cfg, microrl_exec_fn exec_fn);
+#if MICRORL_CFG_USE_COMPLETE
+microrlr_t  microrl_config_set_complete_callback(microrl_config_t* cfg, microrl_get_compl_fn get_completion_fn);
+microrlr_t  microrl_config_set_complete_list_callback(microrl_config_t* cfg, microrl_get_compl_list_fn get_compl_list_fn);
+#if MICRORL_CFG_USE_COMPLETE_TABLE
+microrlr_t  microrl_config_set_complete_table(microrl_config_t* cfg, const char* const* table_ptr, size_t table_len);
+#endif /* MICRORL_CFG_USE_COMPLETE_TABLE */
+#endif /* MICRORL_CFG_USE_COMPLETE */
+#if MICRORL_CFG_USE_CTRL_C
+microrlr_t  microrl_config_set_sigint_callback(microrl_config_t* cfg, microrl_sigint_fn sigint_fn);
+#endif /* MICRORL_CFG_USE_CTRL_C */
+microrlr_t  microrl_config_set_prompt(microrl_config_t* cfg, char* prompt_str);
+#if MICRORL_CFG_USE_TIMING
+microrlr_t  microrl_config_set_timing(microrl_config_t* cfg, microrl_timing_t* timing_arr);
+#endif /* MICRORL_CFG_USE_TIMING */
+
+microrlr_t  microrl_init_shared(microrl_t* mrl, const microrl_config_t* cfg_ptr);
+#if !MICRORL_CFG_USE_SHARED_CONFIG
 microrlr_t  microrl_init(microrl_t* mrl, microrl_output_fn out_fn, microrl_exec_fn exec_fn);
 
 microrlr_t  microrl_set_execute_callback(microrl_t* mrl, microrl_exec_fn exec_fn);
 #if MICRORL_CFG_USE_COMPLETE
 microrlr_t  microrl_set_complete_callback(microrl_t* mrl, microrl_get_compl_fn get_completion_fn);
+microrlr_t  microrl_set_complete_list_callback(microrl_t* mrl, microrl_get_compl_list_fn get_compl_list_fn);
+#if MICRORL_CFG_USE_COMPLETE_TABLE
+microrlr_t  microrl_set_complete_table(microrl_t* mrl, const char* const* table_ptr, size_t table_len);
+#endif /* MICRORL_CFG_USE_COMPLETE_TABLE */
 #endif /* MICRORL_CFG_USE_COMPLETE */
 #if MICRORL_CFG_USE_CTRL_C
 microrlr_t  microrl_set_sigint_callback(microrl_t* mrl, microrl_sigint_fn sigint_fn);
 #endif /* MICRORL_CFG_USE_CTRL_C */
 
 microrlr_t  microrl_set_prompt(microrl_t* mrl, char* prompt_str);
+#if MICRORL_CFG_USE_TIMING
+microrlr_t  microrl_set_timing(microrl_t* mrl, microrl_timing_t* timing_arr);
+#endif /* MICRORL_CFG_USE_TIMING */
+#endif /* !MICRORL_CFG_USE_SHARED_CONFIG */
+
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_FUZZY
+size_t      microrl_complete_fuzzy(const char* pattern_str, size_t pattern_len, const char* const* cand_arr,
+                                   size_t cand_cnt, const char** top_arr, size_t top_k);
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_FUZZY */
 #if MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__
 microrlr_t  microrl_set_echo(microrl_t* mrl, microrl_echo_t echo);
 #endif /* #if MICRORL_CFG_USE_ECHO_OFF */
 
 microrlr_t  microrl_processing_input(microrl_t* mrl, const void* data_ptr, size_t len);
 
+#if MICRORL_CFG_USE_INPUT_RING || __DOXYGEN__
+microrlr_t  microrl_input_ring_init(microrl_input_ring_t* ring);
+size_t      microrl_input_ring_push(microrl_input_ring_t* ring, const void* data_ptr, size_t len);
+microrlr_t  microrl_input_ring_drain(microrl_t* mrl, microrl_input_ring_t* ring);
+#endif /* MICRORL_CFG_USE_INPUT_RING || __DOXYGEN__ */
+#if MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__
+microrlr_t  microrl_command_complete(microrl_t* mrl, int status);
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__ */
+#if MICRORL_CFG_USE_EVENTS || __DOXYGEN__
+microrlr_t  microrl_poll_event(microrl_t* mrl, microrl_event_t* evt_ptr);
+#if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
+microrlr_t  microrl_complete_answer(microrl_t* mrl, const microrl_compl_list_t* cmplt_list_ptr);
+#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
+#endif /* MICRORL_CFG_USE_EVENTS || __DOXYGEN__ */
+#if MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__
+microrlr_t  microrl_print_async(microrl_t* mrl, const char* str);
+microrlr_t  microrl_service(microrl_t* mrl);
+#endif /* MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_STATS || __DOXYGEN__
+microrlr_t  microrl_get_stats(const microrl_t* mrl, microrl_stats_t* stats_ptr);
+microrlr_t  microrl_reset_stats(microrl_t* mrl);
+#endif /* MICRORL_CFG_USE_STATS || __DOXYGEN__ */
+
 uint32_t    microrl_get_version(void);
 
 microrlr_t  microrl_clear_terminal(microrl_t* mrl);
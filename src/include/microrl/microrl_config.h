@@ -88,6 +88,7 @@ extern "C" {
 #define MICRORL_COLOR_PURPLE                  "\033[35m"
 #define MICRORL_COLOR_MAGENTA                 "\033[36m"
 #define MICRORL_COLOR_WHITE                   "\033[37m"
+#define MICRORL_COLOR_DIM                     "\033[2m"
 #define MICRORL_COLOR_DEFAULT                 "\033[0m"
 
 /**
@@ -105,6 +106,65 @@ extern "C" {
 #define MICRORL_CFG_USE_COMPLETE              0
 #endif
 
+/**
+ * \brief           Enable it, if you want to use built-in completion of the command name (first token)
+ *                  by the sorted table of commands set with 'microrl_set_complete_table()'.
+ *                  Matching commands are found by binary search, so the completion callback is only
+ *                  needed to complete command arguments. Requires \ref MICRORL_CFG_USE_COMPLETE
+ */
+#ifndef MICRORL_CFG_USE_COMPLETE_TABLE
+#define MICRORL_CFG_USE_COMPLETE_TABLE        0
+#endif
+
+/**
+ * \brief           Enable it to cycle through completion candidates by pressing 'Tab' repeatedly.
+ *                  First 'Tab' prints candidates as usual and caches them, every next 'Tab'
+ *                  replaces the token being completed with the next cached candidate, without
+ *                  calling completion callback again. Any other key stops cycling.
+ *                  Candidates storage must stay valid while cycling, including candidates
+ *                  answered by 'microrl_complete_answer()'.
+ *                  Requires \ref MICRORL_CFG_USE_COMPLETE
+ */
+#ifndef MICRORL_CFG_USE_COMPLETE_CYCLE
+#define MICRORL_CFG_USE_COMPLETE_CYCLE        0
+#endif
+
+/**
+ * \brief           Width of terminal in characters. Multiple completion candidates
+ *                  are printed in as many columns as fit into this width
+ */
+#ifndef MICRORL_CFG_TERMINAL_WIDTH
+#define MICRORL_CFG_TERMINAL_WIDTH            80
+#endif
+
+/**
+ * \brief           Maximum number of completion candidates printed without asking.
+ *                  If there are more candidates, "Display all N possibilities? (y/n)"
+ *                  is asked first to not flood slow link by accident.
+ *                  Set it to 0 to always print candidates without asking
+ */
+#ifndef MICRORL_CFG_COMPL_QUERY_ITEMS
+#define MICRORL_CFG_COMPL_QUERY_ITEMS         100
+#endif
+
+/**
+ * \brief           Enable it to match commands names as subsequences, when no name in
+ *                  completion table starts with the typed word. Candidates are scored by
+ *                  contiguity of matched characters and matches at words start, and best
+ *                  \ref MICRORL_CFG_COMPL_FUZZY_TOP_K of them are offered in ranked order.
+ *                  Requires \ref MICRORL_CFG_USE_COMPLETE
+ */
+#ifndef MICRORL_CFG_USE_COMPLETE_FUZZY
+#define MICRORL_CFG_USE_COMPLETE_FUZZY        0
+#endif
+
+/**
+ * \brief           Maximum number of ranked fuzzy completion candidates
+ */
+#ifndef MICRORL_CFG_COMPL_FUZZY_TOP_K
+#define MICRORL_CFG_COMPL_FUZZY_TOP_K         8
+#endif
+
 /**
  * \brief           Enable it, if you want to allow quoting command arguments to include spaces.
  *                  Quoting protects whitespace, for example, 2 quoted tokens:
@@ -157,6 +217,37 @@ extern "C" {
 #define MICRORL_CFG_RING_HISTORY_LEN          64
 #endif
 
+/**
+ * \brief           Enable it to store history records front-coded. Each record is saved as
+ *                  the length of the prefix shared with the previous record followed by the
+ *                  remaining suffix, so commands with long common prefixes take much less space
+ *                  in the ring buffer. Overhead is 1 char more on each saved record.
+ *                  Records are decoded on the fly when navigating history.
+ * \note            Command line length \ref MICRORL_CFG_CMDLINE_LEN must not exceed 254
+ */
+#ifndef MICRORL_CFG_USE_HISTORY_FRONT_CODING
+#define MICRORL_CFG_USE_HISTORY_FRONT_CODING  0
+#endif
+
+/**
+ * \brief           Enable it to suggest completion of the typed line from history. The rest of
+ *                  the newest history record starting with the line is printed after cursor with
+ *                  \ref MICRORL_CFG_HINT_COLOR, pressing 'RIGHT' or Ctrl+F at the end of line
+ *                  accepts it. Using of hints increases memory consumption by
+ *                  \ref MICRORL_CFG_CMDLINE_LEN bytes.
+ *                  Requires \ref MICRORL_CFG_USE_HISTORY
+ */
+#ifndef MICRORL_CFG_USE_HISTORY_HINTS
+#define MICRORL_CFG_USE_HISTORY_HINTS         0
+#endif
+
+/**
+ * \brief           Color escape code of history suggestion printed after cursor
+ */
+#ifndef MICRORL_CFG_HINT_COLOR
+#define MICRORL_CFG_HINT_COLOR                MICRORL_COLOR_DIM
+#endif
+
 /**
  * \brief           Size of the buffer used for piecemeal printing of part or all of the command
  *                  line buffer. Allocated on the stack. Must be at least 16.
@@ -179,6 +270,7 @@ extern "C" {
  *                  this adds some overhead. If not enabled, that uses my own number conversion code,
  *                  which save about 800 byte of code size on AVR (avr-gcc build).
  *                  Try to build with and without, and compare total code size for tune library.
+ *                  `make size` in examples prints code size of library built with every feature for host and MCUs
  */
 #ifndef MICRORL_CFG_USE_LIBC_STDIO
 #define MICRORL_CFG_USE_LIBC_STDIO            0
@@ -220,6 +312,170 @@ extern "C" {
 #define MICRORL_CFG_END_LINE                  "\r\n"
 #endif
 
+/**
+ * \brief           Enable it to use lock-free single-producer/single-consumer input ring buffer.
+ *                  Interrupt handler (UART RX, DMA callback) pushes received characters into the ring
+ *                  with 'microrl_input_ring_push()' and main loop passes them to the instance at once
+ *                  with 'microrl_input_ring_drain()'
+ */
+#ifndef MICRORL_CFG_USE_INPUT_RING
+#define MICRORL_CFG_USE_INPUT_RING            0
+#endif
+
+/**
+ * \brief           Size of the input ring buffer, must be a power of 2. Up to 128 bytes the ring indexes
+ *                  are 8-bit, so they are read and written atomically on any MCU.
+ *                  The ring must hold all characters received while the longest command is executed
+ */
+#ifndef MICRORL_CFG_INPUT_RING_LEN
+#define MICRORL_CFG_INPUT_RING_LEN            128
+#endif
+
+/**
+ * \brief           Memory barrier between access to data of the input ring buffer and its indexes.
+ *                  Compiler barrier is enough on single core MCU, full barrier is used with GCC.
+ *                  Define it for your compiler, for example as `__DMB()` with CMSIS or `__memory_changed()` with IAR
+ */
+#ifndef MICRORL_CFG_INPUT_RING_BARRIER
+#if defined(__GNUC__)
+#define MICRORL_CFG_INPUT_RING_BARRIER()      __sync_synchronize()
+#else
+#define MICRORL_CFG_INPUT_RING_BARRIER()
+#endif
+#endif
+
+/**
+ * \brief           Enable it to print messages from other threads and interrupts with 'microrl_print_async()'.
+ *                  Messages are queued in lock-free multi-producer/single-consumer queue and printed above
+ *                  the prompt by 'microrl_service()', which redraws prompt and command line once for all of them
+ */
+#ifndef MICRORL_CFG_USE_ASYNC_PRINT
+#define MICRORL_CFG_USE_ASYNC_PRINT           0
+#endif
+
+/**
+ * \brief           Number of messages in asynchronous print queue, must be a power of 2, at least 2
+ *                  and not more than 64
+ */
+#ifndef MICRORL_CFG_ASYNC_PRINT_MSG_NUM
+#define MICRORL_CFG_ASYNC_PRINT_MSG_NUM       8
+#endif
+
+/**
+ * \brief           Maximum length of asynchronously printed message, longer messages are truncated
+ */
+#ifndef MICRORL_CFG_ASYNC_PRINT_MSG_LEN
+#define MICRORL_CFG_ASYNC_PRINT_MSG_LEN       64
+#endif
+
+/**
+ * \brief           Atomic operations on 8-bit indexes of asynchronous print queue:
+ *                  load with acquire, store with release and compare-and-swap semantic.
+ *                  GCC builtins are used by default, define them for other compilers or for MCU
+ *                  without exclusive access instructions, for example with disabled interrupts
+ */
+#if defined(__GNUC__)
+#ifndef MICRORL_CFG_ASYNC_PRINT_LOAD
+#define MICRORL_CFG_ASYNC_PRINT_LOAD(ptr)     __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#endif
+#ifndef MICRORL_CFG_ASYNC_PRINT_STORE
+#define MICRORL_CFG_ASYNC_PRINT_STORE(ptr, val)                                                         \
+                                              __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#endif
+#ifndef MICRORL_CFG_ASYNC_PRINT_CAS
+#define MICRORL_CFG_ASYNC_PRINT_CAS(ptr, exp_ptr, val)                                                  \
+                                              __atomic_compare_exchange_n((ptr), (exp_ptr), (val), 0,    \
+                                                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#endif
+#endif /* defined(__GNUC__) */
+
+/**
+ * \brief           Enable it to poll events with 'microrl_poll_event()' instead of callbacks, which are set to NULL.
+ *                  Entered line, completion request and Ctrl+C are queued as events, that host processes
+ *                  when and where it wants, e.g. in a worker pool. Requires \ref MICRORL_CFG_USE_DEFERRED_EXEC
+ */
+#ifndef MICRORL_CFG_USE_EVENTS
+#define MICRORL_CFG_USE_EVENTS                0
+#endif
+
+/**
+ * \brief           Enable it to let command execute callback return \ref MICRORL_EXEC_PENDING and finish
+ *                  the command later in another task. Prompt is printed by 'microrl_command_complete()',
+ *                  input received meanwhile is kept without echo and processed after that
+ */
+#ifndef MICRORL_CFG_USE_DEFERRED_EXEC
+#define MICRORL_CFG_USE_DEFERRED_EXEC         MICRORL_CFG_USE_EVENTS
+#endif
+
+/**
+ * \brief           Size of the buffer for characters typed ahead while deferred command is executed.
+ *                  Must not be more than \ref MICRORL_CFG_CMDLINE_LEN
+ */
+#ifndef MICRORL_CFG_EXEC_TYPEAHEAD_LEN
+#define MICRORL_CFG_EXEC_TYPEAHEAD_LEN        MICRORL_CFG_CMDLINE_LEN
+#endif
+
+/**
+ * \brief           Enable it to count input and output bytes, output callback calls, command line redraws,
+ *                  history lookups and completions of instance. Counters are read with 'microrl_get_stats()',
+ *                  e.g. to export traffic caused by terminal on a slow shared link to telemetry
+ */
+#ifndef MICRORL_CFG_USE_STATS
+#define MICRORL_CFG_USE_STATS                 0
+#endif
+
+/**
+ * \brief           Enable it to measure execution time of commands with \ref MICRORL_CFG_TIMING_GET_TICK and
+ *                  collect log2 histograms of it per command of completion table, set by 'microrl_config_set_timing()'.
+ *                  Deferred commands are measured until 'microrl_command_complete()'. Histograms are printed
+ *                  by built-in \ref MICRORL_CFG_TIMING_CMD command, so slow handlers are found without a profiler
+ */
+#ifndef MICRORL_CFG_USE_TIMING
+#define MICRORL_CFG_USE_TIMING                0
+#endif
+
+/**
+ * \brief           Get current value of free-running 32-bit tick counter, required by \ref MICRORL_CFG_USE_TIMING.
+ *                  Difference of two values is the time between them even after counter wraps around,
+ *                  so any unit fits, e.g. `DWT->CYCCNT` on Cortex-M or microseconds of `clock_gettime()`
+ */
+#if defined(__DOXYGEN__)
+#define MICRORL_CFG_TIMING_GET_TICK()         0
+#endif
+
+/**
+ * \brief           Number of histogram buckets. Bucket `N` counts commands executed in `2^N` to `2^(N+1) - 1` ticks,
+ *                  bucket `0` counts the ones executed in less than 2 ticks and the last one all the longer ones
+ */
+#ifndef MICRORL_CFG_TIMING_BUCKETS
+#define MICRORL_CFG_TIMING_BUCKETS            24
+#endif
+
+/**
+ * \brief           Name of built-in command printing histograms. With argument `reset` it clears them.
+ *                  The command isn't passed to execute callback, rename it if it's taken
+ */
+#ifndef MICRORL_CFG_TIMING_CMD
+#define MICRORL_CFG_TIMING_CMD                "stats"
+#endif
+
+/**
+ * \brief           Unit of ticks printed by built-in \ref MICRORL_CFG_TIMING_CMD command
+ */
+#ifndef MICRORL_CFG_TIMING_UNIT
+#define MICRORL_CFG_TIMING_UNIT               "ticks"
+#endif
+
+/**
+ * \brief           Enable it to share one read-only configuration (callbacks, prompt, table of commands)
+ *                  between many instances. Every instance keeps only the pointer to configuration
+ *                  set by 'microrl_init_shared()', instead of its own copy. Per-instance setters of callbacks
+ *                  and prompt are not available then, use 'microrl_config_set_...()' functions instead
+ */
+#ifndef MICRORL_CFG_USE_SHARED_CONFIG
+#define MICRORL_CFG_USE_SHARED_CONFIG         0
+#endif
+
 /**
  * \brief           Enable it to use user-defined pre- and post- command execute callbacks (hooks)
  */
@@ -241,15 +497,29 @@ extern "C" {
 /**
  * \brief           Optional user implemented function called after command execution callback
  *                      Not called if \ref MICRORL_CFG_USE_COMMAND_HOOKS is set to 0
+ * \note            For command finished by 'microrl_command_complete()' after execute callback returned
+ *                      \ref MICRORL_EXEC_PENDING, argc is 0 and argv is a valid empty list,
+ *                      as the line is not kept then
  * \param[in]       mrl: Pointer to microRL working instance
  * \param[in]       res: Return value of the command execution callback
- * \param[in]       argc: Number of arguments in command line
+ * \param[in]       argc: Number of arguments in command line, may be 0 for deferred command
  * \param[in]       argv: Pointer to argument list
  */
 #ifndef MICRORL_POST_COMMAND_HOOK
 #define MICRORL_POST_COMMAND_HOOK(mrl, res, argc, argv)
 #endif
 
+/**
+ * \brief           Output function called directly by the library instead of the output callback of instance,
+ *                  e.g. `#define MICRORL_CFG_OUT_FN(mrl, str)   uart_print((mrl), (str))`. When the library
+ *                  is compiled in the same translation unit with it, like single header build `microrl_single.h`
+ *                  does, the function is inlined into the library. Output callback passed to 'microrl_init()'
+ *                  may be `NULL` then
+ */
+#if defined(__DOXYGEN__)
+#define MICRORL_CFG_OUT_FN(mrl, str)
+#endif
+
 /**
  * \brief           Set compiler specific keywords notation for inline functions
  *                      In GGC the 'inline' is used, but in KEIL-MDK the '__inline' is used
@@ -258,6 +528,20 @@ extern "C" {
 #ifndef MICRORL_CFG_STATIC_INLINE
 #define MICRORL_CFG_STATIC_INLINE             static inline
 #endif
+
+/**
+ * \brief           Set compiler specific keywords notation for functions, that must not be inlined.
+ *                      Functions with token arrays and completion printing are kept out of the stack frame
+ *                      of input processing, so their frames are on stack only while they are called
+ * \note            You can set just 'static' option, if compiler has no such keyword
+ */
+#ifndef MICRORL_CFG_STATIC_NOINLINE
+#if defined(__GNUC__)
+#define MICRORL_CFG_STATIC_NOINLINE           static __attribute__((noinline))
+#else
+#define MICRORL_CFG_STATIC_NOINLINE           static
+#endif
+#endif
 /**
  * \}
  */
@@ -36,6 +36,59 @@
 
 #define IS_CONTROL_CHAR(x)                  ((x) <= MICRORL_ESC_ANSI_US || (x) == MICRORL_ESC_ANSI_DEL)
 
+#if MICRORL_CFG_USE_SHARED_CONFIG
+#define MICRORL_CONFIG(mrl)                 ((mrl)->cfg_ptr)    /*!< Configuration shared by instances */
+#else
+#define MICRORL_CONFIG(mrl)                 (&(mrl)->cfg)       /*!< Own configuration of instance */
+#endif /* MICRORL_CFG_USE_SHARED_CONFIG */
+
+#if MICRORL_CFG_USE_EVENTS
+#define MICRORL_EXEC_FN_INVALID(fn)         0                   /*!< Line events are raised without callback */
+#else
+#define MICRORL_EXEC_FN_INVALID(fn)         ((fn) == NULL)      /*!< Execute callback is required */
+#endif /* MICRORL_CFG_USE_EVENTS */
+
+#if defined(MICRORL_CFG_OUT_FN)
+#define MICRORL_OUT_FN_INVALID(fn)          0                   /*!< Output is written by \ref MICRORL_CFG_OUT_FN */
+#else
+#define MICRORL_OUT_FN_INVALID(fn)          ((fn) == NULL)      /*!< Output callback is required */
+#endif /* defined(MICRORL_CFG_OUT_FN) */
+
+#if MICRORL_CFG_USE_STATS
+#define MICRORL_STATS_ADD(mrl, cnt, val)    ((mrl)->stats.cnt += (uint32_t)(val))   /*!< Update counter of instance */
+#else
+#define MICRORL_STATS_ADD(mrl, cnt, val)                                            /*!< Counters are disabled */
+#endif /* MICRORL_CFG_USE_STATS */
+
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_FUZZY
+#define MICRORL_FUZZY_NO_MATCH              INT32_MIN   /*!< Candidate doesn't contain pattern as subsequence */
+#define MICRORL_FUZZY_SCORE_MATCH           16          /*!< Score for every matched character */
+#define MICRORL_FUZZY_BONUS_CONTIGUOUS      16          /*!< Bonus for character matched right after previous one */
+#define MICRORL_FUZZY_BONUS_WORD_START      24          /*!< Bonus for character matched at start of a word */
+#define MICRORL_FUZZY_PENALTY_GAP           1           /*!< Penalty for every skipped character */
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_FUZZY */
+
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_FRONT_CODING && (MICRORL_CFG_CMDLINE_LEN > 254)
+#error "MICRORL_CFG_CMDLINE_LEN must not exceed 254 when MICRORL_CFG_USE_HISTORY_FRONT_CODING is enabled"
+#endif
+
+#if MICRORL_CFG_USE_ASYNC_PRINT && (!defined(MICRORL_CFG_ASYNC_PRINT_LOAD) || !defined(MICRORL_CFG_ASYNC_PRINT_STORE) \
+                                    || !defined(MICRORL_CFG_ASYNC_PRINT_CAS))
+#error "Define MICRORL_CFG_ASYNC_PRINT_LOAD, _STORE and _CAS atomic operations for your compiler"
+#endif
+
+#if MICRORL_CFG_USE_EVENTS && !MICRORL_CFG_USE_DEFERRED_EXEC
+#error "MICRORL_CFG_USE_EVENTS requires MICRORL_CFG_USE_DEFERRED_EXEC"
+#endif
+
+#if MICRORL_CFG_USE_DEFERRED_EXEC && (MICRORL_CFG_EXEC_TYPEAHEAD_LEN > MICRORL_CFG_CMDLINE_LEN)
+#error "MICRORL_CFG_EXEC_TYPEAHEAD_LEN must not exceed MICRORL_CFG_CMDLINE_LEN"
+#endif
+
+#if MICRORL_CFG_USE_TIMING && !defined(MICRORL_CFG_TIMING_GET_TICK)
+#error "Define MICRORL_CFG_TIMING_GET_TICK tick source to use MICRORL_CFG_USE_TIMING"
+#endif
+
 /**
  * \brief           List of ANSI escape codes
  */
@@ -165,6 +218,19 @@ static microrlr_t prv_cmdline_buf_split(microrl_t* mrl, const char** tkn_str_arr
     return microrlOK;
 }
 
+#if MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__
+/**
+ * \brief           Check if command line character is printed masked, as echo is off
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       pos: Position of character in command line
+ * \return          `1` if character is printed as \ref MICRORL_CFG_ECHO_OFF_MASK, `0` otherwise
+ */
+MICRORL_CFG_STATIC_INLINE uint8_t prv_echo_is_masked(const microrl_t* mrl, size_t pos) {
+    return (mrl->echo != MICRORL_ECHO_ON)
+            && ((mrl->echo_off_pos == MICRORL_CMDLINE_IDX_NONE) || (pos >= mrl->echo_off_pos));
+}
+#endif /* MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__ */
+
 /**
  * \brief           Insert the passed text at the cursor position
  * \param[in,out]   mrl: \ref microrl_t working instance
@@ -178,7 +244,7 @@ static microrlr_t prv_cmdline_buf_insert_text(microrl_t* mrl, const char* text_s
     }
 
 #if MICRORL_CFG_USE_ECHO_OFF
-    if ((mrl->echo != MICRORL_ECHO_ON) && (mrl->echo_off_pos == -1)) {
+    if ((mrl->echo != MICRORL_ECHO_ON) && (mrl->echo_off_pos == MICRORL_CMDLINE_IDX_NONE)) {
         mrl->echo_off_pos = mrl->cmdlen;
     }
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
@@ -239,17 +305,32 @@ MICRORL_CFG_STATIC_INLINE void prv_cmdline_buf_reset(microrl_t* mrl) {
     mrl->cursor = 0;
 }
 
+/**
+ * \brief           Write string to terminal with output callback of instance or \ref MICRORL_CFG_OUT_FN
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       str: String to write
+ */
+MICRORL_CFG_STATIC_INLINE void prv_terminal_write(microrl_t* mrl, const char* str) {
+    MICRORL_STATS_ADD(mrl, out_calls, 1);
+    MICRORL_STATS_ADD(mrl, out_bytes, strlen(str));
+#if defined(MICRORL_CFG_OUT_FN)
+    MICRORL_CFG_OUT_FN(mrl, str);
+#else
+    MICRORL_CONFIG(mrl)->out_fn(mrl, str);
+#endif /* defined(MICRORL_CFG_OUT_FN) */
+}
+
 /**
  * \brief           Print prompt string in terminal
  * \param[in]       mrl: \ref microrl_t working instance
  */
 MICRORL_CFG_STATIC_INLINE void prv_terminal_print_prompt(microrl_t* mrl) {
 #if MICRORL_CFG_USE_PROMPT_COLOR
-    mrl->out_fn(mrl, MICRORL_CFG_PROMPT_COLOR);
-    mrl->out_fn(mrl, mrl->prompt_ptr);
-    mrl->out_fn(mrl, MICRORL_COLOR_DEFAULT);
+    prv_terminal_write(mrl, MICRORL_CFG_PROMPT_COLOR);
+    prv_terminal_write(mrl, MICRORL_CONFIG(mrl)->prompt_ptr);
+    prv_terminal_write(mrl, MICRORL_COLOR_DEFAULT);
 #else
-    mrl->out_fn(mrl, mrl->prompt_ptr);
+    prv_terminal_write(mrl, MICRORL_CONFIG(mrl)->prompt_ptr);
 #endif
 }
 
@@ -259,7 +340,7 @@ MICRORL_CFG_STATIC_INLINE void prv_terminal_print_prompt(microrl_t* mrl) {
  * \param[in]       mrl: \ref microrl_t working instance
  */
 MICRORL_CFG_STATIC_INLINE void prv_terminal_backspace(microrl_t* mrl) {
-    mrl->out_fn(mrl, "\033[D \033[D");
+    prv_terminal_write(mrl, "\033[D \033[D");
 }
 
 /**
@@ -267,7 +348,68 @@ MICRORL_CFG_STATIC_INLINE void prv_terminal_backspace(microrl_t* mrl) {
  * \param[in]       mrl: \ref microrl_t working instance
  */
 MICRORL_CFG_STATIC_INLINE void prv_terminal_newline(microrl_t* mrl) {
-    mrl->out_fn(mrl, MICRORL_CFG_END_LINE);
+    prv_terminal_write(mrl, MICRORL_CFG_END_LINE);
+}
+
+#if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
+/**
+ * \brief           Erase completion candidates printed below command line,
+ *                      when cursor is moved to the next line
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void prv_complete_erase_list(microrl_t* mrl) {
+    if (mrl->compl_list_shown) {
+        prv_terminal_write(mrl, "\033[J");
+        mrl->compl_list_shown = 0;
+    }
+}
+#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_EVENTS || __DOXYGEN__
+/**
+ * \brief           Raise line or completion event. Command line is kept for zero-copy arguments
+ *                      and input is typed ahead until the event is finished
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       type: Type of event, \ref MICRORL_EVENT_LINE or \ref MICRORL_EVENT_COMPLETE
+ * \param[in]       argc: Number of tokens
+ * \param[in]       argv: Tokens in command line buffer
+ */
+static void prv_event_raise(microrl_t* mrl, microrl_event_type_t type, uint8_t argc, const char* const* argv) {
+    memcpy(mrl->evt_argv, argv, argc * sizeof(argv[0]));
+    mrl->evt_argv[argc] = NULL;
+    mrl->evt_argc = argc;
+    mrl->evt_type = type;
+    mrl->evt_polled = 0;
+    mrl->exec_pending = 1;
+}
+#endif /* MICRORL_CFG_USE_EVENTS || __DOXYGEN__ */
+
+/**
+ * \brief           Convert unsigned number to decimal string
+ *                      The passed string must be at least 11 bytes long
+ * \param[out]      str: String to write the number to
+ * \param[in]       num: Number to convert
+ * \return          Pointer to terminating NULL character of the written string
+ */
+static char* prv_num_to_str(char* str, uint32_t num) {
+#if MICRORL_CFG_USE_LIBC_STDIO
+    str += sprintf(str, "%lu", (unsigned long)num);
+#else
+    char tmp_str[10];
+    size_t i = 0;
+
+    do {
+        tmp_str[i++] = (num % 10) + '0';
+        num /= 10;
+    } while (num > 0);
+
+    while (i > 0) {                             /* Write reversed numerals to result */
+        *str++ = tmp_str[--i];
+    }
+    *str = '\0';
+#endif /* MICRORL_CFG_USE_LIBC_STDIO */
+
+    return str;
 }
 
 /**
@@ -296,27 +438,35 @@ static char* prv_cursor_generate_move(char* str, int32_t offset) {
         return str;
     }
 
-#if MICRORL_CFG_USE_LIBC_STDIO
-    str += sprintf(str, "\033[%d%c", offset, c);
-#else
     *str++ = '\033';
     *str++ = '[';
+    str = prv_num_to_str(str, (uint32_t)offset);
+    *str++ = c;
+    *str = '\0';
 
-    char tmp_str[4] = {0};
-    size_t i = 0;
-
-    while (offset > 0) {
-        tmp_str[i++] = (offset % 10) + '0';
-        offset /= 10;
-    }
+    return str;
+}
 
-    for (size_t j = 0; j < i; ++j) {            /* Write reversed numerals to result */
-        *str++ = tmp_str[i - j - 1];
-    }
+/**
+ * \brief           Insert ESC sequence into the passed string to set the cursor
+ *                      at the passed position of command line, wherever the cursor
+ *                      is in the current terminal line.
+ *                      The passed string must be at least 15 bytes long
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       str: The original string before moving the cursor
+ * \param[in]       pos: Position in command line to set cursor at
+ * \return          The original string after moving the cursor
+ */
+static char* prv_cursor_generate_line_pos(microrl_t* mrl, char* str, int32_t pos) {
+    size_t prompt_size = MICRORL_CONFIG(mrl)->prompt_size;
 
-    *str++ = c;
-    *str = '\0';
-#endif /* MICRORL_CFG_USE_LIBC_STDIO */
+#if MICRORL_CFG_USE_CARRIAGE_RETURN
+    *str++ = '\r';
+    str = prv_cursor_generate_move(str, prompt_size + pos);
+#else
+    str = prv_cursor_generate_move(str, -(MICRORL_ARRAYSIZE(mrl->cmdline_str) - 1 + prompt_size + 2));
+    str = prv_cursor_generate_move(str, prompt_size + pos);
+#endif /* MICRORL_CFG_USE_CARRIAGE_RETURN */
 
     return str;
 }
@@ -334,7 +484,7 @@ static void prv_terminal_move_cursor(microrl_t* mrl, int32_t offset) {
 
     char str[16] = {0};
     prv_cursor_generate_move(str, offset);
-    mrl->out_fn(mrl, str);
+    prv_terminal_write(mrl, str);
 }
 
 /**
@@ -347,37 +497,37 @@ static void prv_terminal_print_line(microrl_t* mrl, int32_t pos, uint8_t reset)
     char str[MICRORL_CFG_PRINT_BUFFER_LEN] = {0};
     char* str_ptr = str;
 
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+    mrl->hint_shown = 0;                        /* Suggestion is erased with the end of line */
+    mrl->hint_pos = MICRORL_CMDLINE_IDX_NONE;
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
+
     if (reset) {
-#if MICRORL_CFG_USE_CARRIAGE_RETURN
-        *str_ptr++ = '\r';
-        str_ptr = prv_cursor_generate_move(str_ptr, mrl->prompt_size + pos);
-#else
-        str_ptr = prv_cursor_generate_move(str_ptr, -(MICRORL_ARRAYSIZE(mrl->cmdline_str) - 1 + mrl->prompt_size + 2));
-        str_ptr = prv_cursor_generate_move(str_ptr, mrl->prompt_size + pos);
-#endif /* MICRORL_CFG_USE_CARRIAGE_RETURN */
+        MICRORL_STATS_ADD(mrl, redraws, 1);
+        str_ptr = prv_cursor_generate_line_pos(mrl, str_ptr, pos);
     }
 
     for (size_t i = pos; i < mrl->cmdlen; ++i) {
         *str_ptr = mrl->cmdline_str[i];
 
 #if MICRORL_CFG_USE_ECHO_OFF
-        if (((int32_t)i >= mrl->echo_off_pos) && (mrl->echo != MICRORL_ECHO_ON)) {
+        if (prv_echo_is_masked(mrl, i)) {
             *str_ptr = MICRORL_CFG_ECHO_OFF_MASK;
         }
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
 
         ++str_ptr;
 
-        if ((size_t)(str_ptr - str) == strlen(str)) {
+        if ((size_t)(str_ptr - str) == (MICRORL_ARRAYSIZE(str) - 1)) {  /* Buffer is full, leave place for '\0' */
             *str_ptr = '\0';
-            mrl->out_fn(mrl, str);
+            prv_terminal_write(mrl, str);
             str_ptr = str;
         }
     }
 
     if ((size_t)(str_ptr - str + 3 + 6 + 1) > MICRORL_ARRAYSIZE(str)) {
         *str_ptr = '\0';
-        mrl->out_fn(mrl, str);
+        prv_terminal_write(mrl, str);
         str_ptr = str;
     }
 
@@ -385,7 +535,7 @@ static void prv_terminal_print_line(microrl_t* mrl, int32_t pos, uint8_t reset)
     *str_ptr++ = '[';
     *str_ptr++ = 'K';
     prv_cursor_generate_move(str_ptr, mrl->cursor - mrl->cmdlen);
-    mrl->out_fn(mrl, str);
+    prv_terminal_write(mrl, str);
 }
 
 #if MICRORL_CFG_USE_HISTORY || __DOXYGEN__
@@ -396,16 +546,61 @@ static void prv_terminal_print_line(microrl_t* mrl, int32_t pos, uint8_t reset)
  * \param[in,out]   idx_ptr: Pointer to the current record
  */
 MICRORL_CFG_STATIC_INLINE void prv_hist_next_record(microrl_hist_rbuf_t* rbuf_ptr, size_t* idx_ptr) {
-    while (rbuf_ptr->ring_buf[++(*idx_ptr)] != '\0') {
-        if (*idx_ptr >= MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf)) {
+    do {
+        if (++(*idx_ptr) >= MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf)) {
             *idx_ptr -= MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf);
-            if (rbuf_ptr->ring_buf[*idx_ptr] == '\0') {
-                break;
-            }
         }
+    } while (rbuf_ptr->ring_buf[*idx_ptr] != '\0');
+}
+
+/**
+ * \brief           Get ring buffer position next to the passed one
+ * \param[in]       idx: Current position in ring buffer
+ * \return          Next position in ring buffer
+ */
+MICRORL_CFG_STATIC_INLINE size_t prv_hist_idx_next(size_t idx) {
+    return (idx + 1 < MICRORL_CFG_RING_HISTORY_LEN) ? (idx + 1) : 0;
+}
+
+/**
+ * \brief           Get ring buffer position previous to the passed one
+ * \param[in]       idx: Current position in ring buffer
+ * \return          Previous position in ring buffer
+ */
+MICRORL_CFG_STATIC_INLINE size_t prv_hist_idx_prev(size_t idx) {
+    return (idx > 0) ? (idx - 1) : (MICRORL_CFG_RING_HISTORY_LEN - 1);
+}
+
+#if MICRORL_CFG_USE_HISTORY_FRONT_CODING || __DOXYGEN__
+
+/**
+ * \brief           Decode front-coded record on top of the previous decoded record
+ *
+ * Record is stored as the length of the prefix shared with the previous record plus one
+ * followed by the remaining suffix and terminating zero
+ *
+ * \param[in]       rbuf_ptr: Pointer to \ref microrl_hist_rbuf_t structure
+ * \param[in,out]   idx_ptr: Position of '\0' marker preceding the record.
+ *                      Set to position of the record terminating '\0' on return
+ * \param[in,out]   line_str: Previous decoded record, replaced with the decoded one
+ * \return          Length of decoded record
+ */
+static size_t prv_hist_decode_next(const microrl_hist_rbuf_t* rbuf_ptr, size_t* idx_ptr, char* line_str) {
+    size_t idx = prv_hist_idx_next(*idx_ptr);
+    size_t len = (uint8_t)rbuf_ptr->ring_buf[idx] - 1;
+
+    idx = prv_hist_idx_next(idx);
+    while (rbuf_ptr->ring_buf[idx] != '\0') {
+        line_str[len++] = rbuf_ptr->ring_buf[idx];
+        idx = prv_hist_idx_next(idx);
     }
+    *idx_ptr = idx;
+
+    return len;
 }
 
+#endif /* MICRORL_CFG_USE_HISTORY_FRONT_CODING || __DOXYGEN__ */
+
 /**
  * \brief           Remove older record from ring buffer
  * \param[in,out]   rbuf_ptr: Pointer to \ref microrl_hist_rbuf_t structure
@@ -413,6 +608,28 @@ MICRORL_CFG_STATIC_INLINE void prv_hist_next_record(microrl_hist_rbuf_t* rbuf_pt
 static void prv_hist_erase_older(microrl_hist_rbuf_t* rbuf_ptr) {
     size_t new_pos = rbuf_ptr->head;
     prv_hist_next_record(rbuf_ptr, &new_pos);
+
+#if MICRORL_CFG_USE_HISTORY_FRONT_CODING
+    /*
+     * Next record becomes the oldest one and can't refer to the erased record anymore.
+     * Copy the shared prefix from the erased record right before the record suffix,
+     * it always fits into the space freed by the erased record
+     */
+    if (new_pos != rbuf_ptr->tail) {
+        size_t dst = prv_hist_idx_next(new_pos);
+        size_t src = (rbuf_ptr->head + (uint8_t)rbuf_ptr->ring_buf[dst]) % MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf);
+
+        for (size_t shared = (uint8_t)rbuf_ptr->ring_buf[dst] - 1; shared > 0; --shared) {
+            rbuf_ptr->ring_buf[dst] = rbuf_ptr->ring_buf[src];
+            dst = prv_hist_idx_prev(dst);
+            src = prv_hist_idx_prev(src);
+        }
+        rbuf_ptr->ring_buf[dst] = 1;            /* Nothing shared with the previous record */
+        new_pos = prv_hist_idx_prev(dst);
+        rbuf_ptr->ring_buf[new_pos] = '\0';
+    }
+#endif /* MICRORL_CFG_USE_HISTORY_FRONT_CODING */
+
     rbuf_ptr->head = new_pos;
 }
 
@@ -428,7 +645,7 @@ static microrl_hist_status_t prv_hist_is_space_for_new(microrl_hist_rbuf_t* rbuf
             return MICRORL_HIST_NOT_FULL;
         }
     } else {
-        if ((rbuf_ptr->head - rbuf_ptr->tail - 1) > len) {
+        if ((size_t)(rbuf_ptr->head - rbuf_ptr->tail - 1) > len) {
             return MICRORL_HIST_NOT_FULL;
         }
     }
@@ -474,13 +691,26 @@ static size_t prv_hist_restore_line(microrl_hist_rbuf_t* rbuf_ptr, char* line_st
             break;
     }
 
+#if MICRORL_CFG_USE_HISTORY_FRONT_CODING
+    size_t rec_len = 0;
+
+    if (rbuf_ptr->count != 0) {                 /* Decode records from the oldest up to the requested one */
+        size_t idx = rbuf_ptr->head;
+        for (size_t j = cnt - rbuf_ptr->count + 1; j > 0; --j) {
+            rec_len = prv_hist_decode_next(rbuf_ptr, &idx, line_str);
+        }
+    }
+    memset(line_str + rec_len, 0x00, MICRORL_CFG_CMDLINE_LEN - rec_len);
+
+    return rec_len;
+#else
     size_t idx = rbuf_ptr->head;
     size_t j = 0;
     while ((cnt - j++) != rbuf_ptr->count) {    /* Find record for 'rbuf_ptr->count' counter */
         prv_hist_next_record(rbuf_ptr, &idx);
     }
 
-    ++idx;                                      /* Move position from `\0` marker */
+    idx = prv_hist_idx_next(idx);               /* Move position from `\0` marker */
 
     size_t rec_len = 0;
     size_t k = idx;
@@ -501,6 +731,7 @@ static size_t prv_hist_restore_line(microrl_hist_rbuf_t* rbuf_ptr, char* line_st
     }
 
     return rec_len;
+#endif /* MICRORL_CFG_USE_HISTORY_FRONT_CODING */
 }
 
 /**
@@ -515,12 +746,71 @@ static void prv_hist_search(microrl_t* mrl, microrl_hist_dir_t dir) {
     }
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
 
+    MICRORL_STATS_ADD(mrl, hist_lookups, 1);
     size_t len = prv_hist_restore_line(&mrl->ring_hist, mrl->cmdline_str, dir);
     memset(&mrl->cmdline_str[len], 0x00, MICRORL_ARRAYSIZE(mrl->cmdline_str) - 1 - len);
     mrl->cursor = mrl->cmdlen = len;
     prv_terminal_print_line(mrl, 0, 1);
 }
 
+/**
+ * \brief           Compare line with the newest record in place in ring buffer, without copying the record
+ * \param[in]       rbuf_ptr: Pointer to \ref microrl_hist_rbuf_t structure
+ * \param[in]       line_str: Line to compare
+ * \param[in]       len: Length of line
+ * \param[out]      rec_len_ptr: Length of the newest record, `0` if history is empty
+ * \return          Length of prefix shared by line and the newest record
+ */
+static size_t prv_hist_cmp_last(const microrl_hist_rbuf_t* rbuf_ptr, const char* line_str, size_t len,
+                                size_t* rec_len_ptr) {
+    size_t shared = 0;
+    size_t rec_len = 0;
+
+#if MICRORL_CFG_USE_HISTORY_FRONT_CODING
+    /*
+     * Records are walked from the oldest one. Line shares with a record no more than the prefix
+     * the record shares with the previous one, and the suffix is compared only if line shares
+     * the whole prefix
+     */
+    size_t idx = rbuf_ptr->head;
+    while (idx != rbuf_ptr->tail) {
+        idx = prv_hist_idx_next(idx);
+        rec_len = (uint8_t)rbuf_ptr->ring_buf[idx] - 1;
+        if (shared > rec_len) {
+            shared = rec_len;
+        }
+
+        idx = prv_hist_idx_next(idx);
+        while (rbuf_ptr->ring_buf[idx] != '\0') {
+            if ((shared == rec_len) && (shared < len) && (line_str[shared] == rbuf_ptr->ring_buf[idx])) {
+                ++shared;
+            }
+            ++rec_len;
+            idx = prv_hist_idx_next(idx);
+        }
+    }
+#else
+    if (rbuf_ptr->head != rbuf_ptr->tail) {
+        size_t idx = prv_hist_idx_prev(rbuf_ptr->tail);
+        while (rbuf_ptr->ring_buf[idx] != '\0') {  /* Find start of the newest record */
+            idx = prv_hist_idx_prev(idx);
+        }
+
+        idx = prv_hist_idx_next(idx);
+        while (idx != rbuf_ptr->tail) {
+            if ((shared == rec_len) && (shared < len) && (line_str[shared] == rbuf_ptr->ring_buf[idx])) {
+                ++shared;
+            }
+            ++rec_len;
+            idx = prv_hist_idx_next(idx);
+        }
+    }
+#endif /* MICRORL_CFG_USE_HISTORY_FRONT_CODING */
+
+    *rec_len_ptr = rec_len;
+    return shared;
+}
+
 /**
  * \brief           Put record to ring buffer
  * \param[in,out]   rbuf_ptr: Pointer to \ref microrl_hist_rbuf_t structure
@@ -528,19 +818,46 @@ static void prv_hist_search(microrl_t* mrl, microrl_hist_dir_t dir) {
  * \param[in]       len: Record length
  */
 static void prv_hist_save_line(microrl_hist_rbuf_t* rbuf_ptr, char* line_str, size_t len) {
+#if MICRORL_CFG_USE_HISTORY_FRONT_CODING
+    if ((len + 1) > (MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf) - 2)) {
+        return;
+    }
+#else
     if (len > (MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf) - 1)) {
         return;
     }
+#endif /* MICRORL_CFG_USE_HISTORY_FRONT_CODING */
 
     /* Don't save the same line as the last record */
-    char last_record_str[MICRORL_CFG_CMDLINE_LEN + 1];
-    prv_hist_restore_line(rbuf_ptr, last_record_str,
-                              rbuf_ptr->count == 1 ? MICRORL_HIST_DIR_NONE : MICRORL_HIST_DIR_UP);
-    if (strcmp(line_str, last_record_str) == 0) {
-        rbuf_ptr->count = 0;
+    size_t last_len;
+    size_t shared = prv_hist_cmp_last(rbuf_ptr, line_str, len, &last_len);
+    rbuf_ptr->count = 0;
+    if ((shared == len) && (last_len == len)) {
         return;
     }
 
+#if MICRORL_CFG_USE_HISTORY_FRONT_CODING
+
+    /* Freeing up space for saving in the ring buffer */
+    while (prv_hist_is_space_for_new(rbuf_ptr, len - shared + 1) == MICRORL_HIST_FULL) {
+        prv_hist_erase_older(rbuf_ptr);
+        if (rbuf_ptr->head == rbuf_ptr->tail) {
+            shared = 0;                         /* Last record is erased, nothing to share */
+        }
+    }
+
+    size_t idx = prv_hist_idx_next(rbuf_ptr->tail);
+    rbuf_ptr->ring_buf[idx] = (char)(shared + 1);   /* Store record */
+    for (size_t i = shared; i < len; ++i) {
+        idx = prv_hist_idx_next(idx);
+        rbuf_ptr->ring_buf[idx] = line_str[i];
+    }
+
+    idx = prv_hist_idx_next(idx);               /* Update position pointer and navigation counter */
+    rbuf_ptr->ring_buf[idx] = '\0';
+    rbuf_ptr->tail = idx;
+    rbuf_ptr->count = 0;
+#else
     /* Freeing up space for saving in the ring buffer */
     while (prv_hist_is_space_for_new(rbuf_ptr, len) == MICRORL_HIST_FULL) {
         prv_hist_erase_older(rbuf_ptr);
@@ -554,13 +871,226 @@ static void prv_hist_save_line(microrl_hist_rbuf_t* rbuf_ptr, char* line_str, si
         memcpy(rbuf_ptr->ring_buf, line_str + part_len, len - part_len);
     }
 
-    rbuf_ptr->tail = rbuf_ptr->tail + len + 1;  /* Update position pointer and navigation counter */
-    if (rbuf_ptr->tail >= MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf)) {
-        rbuf_ptr->tail -= MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf);
+    size_t tail = rbuf_ptr->tail + len + 1;     /* Update position pointer and navigation counter */
+    if (tail >= MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf)) {
+        tail -= MICRORL_ARRAYSIZE(rbuf_ptr->ring_buf);
     }
+    rbuf_ptr->tail = tail;
     rbuf_ptr->ring_buf[rbuf_ptr->tail] = 0;
     rbuf_ptr->count = 0;
+#endif /* MICRORL_CFG_USE_HISTORY_FRONT_CODING */
+}
+
+#if MICRORL_CFG_USE_HISTORY_HINTS || __DOXYGEN__
+/**
+ * \brief           Find the newest record, that starts with the passed line and is longer
+ *                      than it, skipping records newer than the passed one
+ * \param[in]       rbuf_ptr: Pointer to \ref microrl_hist_rbuf_t structure
+ * \param[in]       line_str: Line to find record for
+ * \param[in]       len: Length of line
+ * \param[in]       rec: Number of the first record to check, `1` is the newest record
+ * \param[out]      rec_str: Found record
+ * \param[out]      rec_len_ptr: Length of found record
+ * \return          Number of found record, `0` if there is no such record
+ */
+static size_t prv_hist_find_prefix(const microrl_hist_rbuf_t* rbuf_ptr, const char* line_str, size_t len,
+                                   size_t rec, char* rec_str, size_t* rec_len_ptr) {
+#if MICRORL_CFG_USE_HISTORY_FRONT_CODING
+    /*
+     * Records are decoded only from the oldest one, so newer records are skipped by walking back
+     * to their separators, and the rest is walked forward in a single pass. Common prefix of
+     * every record and the line is found from the one of the previous record and the shared
+     * prefix length, so records aren't decoded to be compared. Only characters after the line
+     * of records starting with it are copied, the rest of such record is the line itself
+     */
+    size_t end = rbuf_ptr->tail;
+    for (size_t num = 1; num < rec; ++num) {    /* Skip records newer than the passed one */
+        if (end == rbuf_ptr->head) {
+            return 0;
+        }
+        do {
+            end = prv_hist_idx_prev(end);
+        } while (rbuf_ptr->ring_buf[end] != '\0');
+    }
+
+    size_t idx = rbuf_ptr->head;
+    size_t match = 0;                           /* Length of common prefix of record and line */
+    size_t cnt = 0;
+    size_t found = 0;
+    size_t found_len = 0;
+    while (idx != end) {
+        idx = prv_hist_idx_next(idx);
+        size_t rec_len = (uint8_t)rbuf_ptr->ring_buf[idx] - 1;
+        if (rec_len < match) {
+            match = rec_len;                    /* Record differs from previous one within common prefix */
+        }
+
+        for (idx = prv_hist_idx_next(idx); rbuf_ptr->ring_buf[idx] != '\0'; idx = prv_hist_idx_next(idx)) {
+            char ch = rbuf_ptr->ring_buf[idx];
+            if ((match == rec_len) && (match < len) && (ch == line_str[match])) {
+                ++match;
+            } else if ((match == len) && (rec_len >= len)) {
+                rec_str[rec_len] = ch;          /* Shared part after the line is left by previous record */
+            }
+            ++rec_len;
+        }
+
+        ++cnt;
+        if ((match == len) && (rec_len > len)) {
+            found = cnt;
+            found_len = rec_len;
+        }
+    }
+
+    if (found == 0) {
+        return 0;
+    }
+    memcpy(rec_str, line_str, len);
+    rec_str[found_len] = '\0';
+    *rec_len_ptr = found_len;
+
+    return rec + cnt - found;                   /* The last walked record is the passed one */
+#else
+    size_t end = rbuf_ptr->tail;
+    size_t num = 0;
+
+    while (end != rbuf_ptr->head) {             /* Walk records from the newest one */
+        size_t start = prv_hist_idx_prev(end);
+        while (rbuf_ptr->ring_buf[start] != '\0') {
+            start = prv_hist_idx_prev(start);
+        }
+
+        if (++num >= rec) {
+            size_t idx = prv_hist_idx_next(start);
+            size_t i = 0;
+            while ((i < len) && (idx != end) && (rbuf_ptr->ring_buf[idx] == line_str[i])) {
+                idx = prv_hist_idx_next(idx);
+                ++i;
+            }
+
+            if ((i == len) && (idx != end)) {
+                i = 0;
+                for (idx = prv_hist_idx_next(start); idx != end; idx = prv_hist_idx_next(idx)) {
+                    rec_str[i++] = rbuf_ptr->ring_buf[idx];
+                }
+                rec_str[i] = '\0';
+                *rec_len_ptr = i;
+                return num;
+            }
+        }
+        end = start;
+    }
+
+    return 0;
+#endif /* MICRORL_CFG_USE_HISTORY_FRONT_CODING */
+}
+
+/**
+ * \brief           Print suggested rest of history record after command line
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void prv_hint_print(microrl_t* mrl) {
+    char str[sizeof(MICRORL_COLOR_DEFAULT) + 10] = MICRORL_COLOR_DEFAULT "\033[K";
+    size_t len = mrl->hint_len - mrl->cmdlen;
+
+    prv_cursor_generate_move(str + strlen(str), -(int32_t)len);
+    prv_terminal_write(mrl, MICRORL_CFG_HINT_COLOR);
+    prv_terminal_write(mrl, mrl->hint_str + mrl->cmdlen);
+    prv_terminal_write(mrl, str);
+    mrl->hint_shown = len;
+}
+
+/**
+ * \brief           Erase suggestion printed after command line, before cursor leaves the line
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void prv_hint_erase(microrl_t* mrl) {
+    if (mrl->hint_shown != 0) {
+        prv_terminal_move_cursor(mrl, mrl->cmdlen - mrl->cursor);
+        prv_terminal_write(mrl, "\033[K");
+        mrl->hint_shown = 0;
+    }
+}
+
+/**
+ * \brief           Update suggestion from history after command line is changed
+ *
+ * While characters are only appended to the line, suggested record is kept as long as it
+ * starts with the line, and typed characters just overwrite the printed suggestion.
+ * Otherwise the search continues from the record older than suggested one, as newer
+ * records didn't start with the shorter line already. Line changed with cursor not at its end
+ * isn't suggested, and the search starts over when cursor is back at the end.
+ *
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void prv_hint_update(microrl_t* mrl) {
+    size_t len = mrl->cmdlen;
+    size_t pos = mrl->hint_pos;
+
+    if (len == pos) {
+        return;                                 /* Line isn't changed */
+    }
+    mrl->hint_pos = len;
+    if (len < pos) {                            /* Line isn't appended, search from the newest record */
+        mrl->hint_len = 0;
+        mrl->hint_rec = 0;
+    }
+
+    if (mrl->cursor != len) {
+        mrl->hint_len = 0;
+        mrl->hint_pos = MICRORL_CMDLINE_IDX_NONE;   /* Search again when cursor is back at the end */
+    } else if ((len == 0)
+#if MICRORL_CFG_USE_ECHO_OFF
+            || (mrl->echo != MICRORL_ECHO_ON)
+#endif /* MICRORL_CFG_USE_ECHO_OFF */
+            ) {
+        mrl->hint_len = 0;
+    } else if ((mrl->hint_len > len) && (memcmp(mrl->hint_str + pos, mrl->cmdline_str + pos, len - pos) == 0)) {
+        if (mrl->hint_shown > (len - pos)) {
+            mrl->hint_shown -= len - pos;       /* Typed characters are printed over suggestion */
+            return;
+        }
+    } else if (mrl->hint_rec != MICRORL_HIST_IDX_NONE) {
+        size_t hint_len = 0;
+        MICRORL_STATS_ADD(mrl, hist_lookups, 1);
+        size_t rec = prv_hist_find_prefix(&mrl->ring_hist, mrl->cmdline_str, len, mrl->hint_rec + 1,
+                                          mrl->hint_str, &hint_len);
+        if (rec == 0) {
+            mrl->hint_rec = MICRORL_HIST_IDX_NONE;
+            mrl->hint_len = 0;
+        } else {
+            mrl->hint_rec = rec;
+            mrl->hint_len = hint_len;
+        }
+    } else {
+        mrl->hint_len = 0;
+    }
+
+    if (mrl->hint_len > len) {
+        prv_hint_print(mrl);
+    } else if (mrl->hint_shown != 0) {
+        prv_terminal_write(mrl, "\033[K");
+        mrl->hint_shown = 0;
+    }
+}
+
+/**
+ * \brief           Accept suggestion printed after command line
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void prv_hint_accept(microrl_t* mrl) {
+    size_t len = mrl->cmdlen;
+
+    if ((mrl->hint_shown == 0) || (mrl->cursor != len)
+            || (prv_cmdline_buf_insert_text(mrl, mrl->hint_str + len, mrl->hint_len - len) != microrlOK)) {
+        return;
+    }
+
+    prv_terminal_write(mrl, mrl->hint_str + len);   /* Print suggestion over itself with usual color */
+    mrl->hint_shown = 0;
+    mrl->hint_pos = mrl->cmdlen;
 }
+#endif /* MICRORL_CFG_USE_HISTORY_HINTS || __DOXYGEN__ */
 
 #endif /* MICRORL_CFG_USE_HISTORY || __DOXYGEN__ */
 
@@ -595,6 +1125,11 @@ static uint8_t prv_escape_process(microrl_t* mrl, char ch) {
                 prv_terminal_move_cursor(mrl, 1);
                 ++mrl->cursor;
             }
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+            else {
+                prv_hint_accept(mrl);
+            }
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
             return 1;
         } else if (ch == 'D') {                 /* LEFT */
             if (mrl->cursor > 0) {
@@ -632,54 +1167,251 @@ static uint8_t prv_escape_process(microrl_t* mrl, char ch) {
 }
 #endif /* MICRORL_CFG_USE_ESC_SEQ || __DOXYGEN__ */
 
+#if MICRORL_CFG_USE_TIMING || __DOXYGEN__
 /**
- * \brief           Processing input string from command line and calling execute_fn() callback
- * \param[in,out]   mrl: \ref microrl_t working instance
- * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ * \brief           Get number of commands in completion table, that have own histograms
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \return          Number of commands
  */
-static microrlr_t prv_handle_newline(microrl_t* mrl) {
-    const char* tkn_str_arr[MICRORL_CFG_CMD_TOKEN_NMB] = {0};
-    uint8_t tkn_cnt = 0;
-    microrlr_t status = microrlOK;
+static size_t prv_timing_table_len(microrl_t* mrl) {
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE
+    if (MICRORL_CONFIG(mrl)->compl_table_ptr != NULL) {
+        return MICRORL_CONFIG(mrl)->compl_table_len;
+    }
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE */
+    MICRORL_UNUSED(mrl);
+    return 0;
+}
 
-    prv_terminal_newline(mrl);
+/**
+ * \brief           Start measuring execution time of command
+ *
+ * Command is found in the sorted completion table by binary search. Commands, that are
+ * not in the table, share the histogram following the ones of the table.
+ *
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       cmd_str: Command name
+ */
+static void prv_timing_start(microrl_t* mrl, const char* cmd_str) {
+    size_t table_len = prv_timing_table_len(mrl);
+    size_t idx = table_len;
 
-    if (mrl->cmdlen == 0) {
-        goto exit;
+    if (MICRORL_CONFIG(mrl)->timing_arr == NULL) {
+        return;
     }
 
-#if MICRORL_CFG_USE_HISTORY
-#if MICRORL_CFG_USE_ECHO_OFF
-    if (mrl->echo == MICRORL_ECHO_ON) {
-#endif /* MICRORL_CFG_USE_ECHO_OFF */
-        prv_hist_save_line(&mrl->ring_hist, mrl->cmdline_str, mrl->cmdlen);
-#if MICRORL_CFG_USE_ECHO_OFF
-    }
-#endif /* MICRORL_CFG_USE_ECHO_OFF */
-#endif /* MICRORL_CFG_USE_HISTORY */
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE
+    size_t lo = 0;
+    size_t hi = table_len;
 
-#if MICRORL_CFG_USE_ECHO_OFF
-    if (mrl->echo == MICRORL_ECHO_ONCE && mrl->cmdline_str[mrl->echo_off_pos] != '\0') {
-        microrl_set_echo(mrl, MICRORL_ECHO_ON);
-        mrl->echo_off_pos = -1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(MICRORL_CONFIG(mrl)->compl_table_ptr[mid], cmd_str);
+        if (cmp == 0) {
+            idx = mid;
+            break;
+        } else if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
     }
-#endif /* MICRORL_CFG_USE_ECHO_OFF */
+#else
+    MICRORL_UNUSED(cmd_str);
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE */
+
+    mrl->timing_ptr = &MICRORL_CONFIG(mrl)->timing_arr[idx];
+    mrl->timing_start = (uint32_t)MICRORL_CFG_TIMING_GET_TICK();
+}
+
+/**
+ * \brief           Put execution time of command to its histogram
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void prv_timing_stop(microrl_t* mrl) {
+    microrl_timing_t* timing_ptr = mrl->timing_ptr;
+    uint32_t ticks;
+    size_t bucket = 0;
+
+    if (timing_ptr == NULL) {
+        return;
+    }
+
+    ticks = (uint32_t)MICRORL_CFG_TIMING_GET_TICK() - mrl->timing_start;
+    for (uint32_t val = ticks >> 1; (val != 0) && (bucket < MICRORL_CFG_TIMING_BUCKETS - 1); val >>= 1) {
+        ++bucket;
+    }
+    ++timing_ptr->count;
+    ++timing_ptr->bucket_arr[bucket];
+    if (ticks > timing_ptr->max) {
+        timing_ptr->max = ticks;
+    }
+    mrl->timing_ptr = NULL;
+}
+
+/**
+ * \brief           Print number right-aligned in the column
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       num: Number to print
+ * \param[in]       width: Width of the column
+ */
+static void prv_timing_print_num(microrl_t* mrl, uint32_t num, size_t width) {
+    char str[40];
+    char num_str[11];
+    size_t len = (size_t)(prv_num_to_str(num_str, num) - num_str);
+    size_t pad = (width > len) ? (width - len) : 1;
+
+    if (pad > sizeof(str) - sizeof(num_str)) {
+        pad = sizeof(str) - sizeof(num_str);
+    }
+    memset(str, ' ', pad);
+    memcpy(str + pad, num_str, len + 1);
+    prv_terminal_write(mrl, str);
+}
+
+/**
+ * \brief           Execute built-in command printing histograms of commands or clearing them
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       argc: argument count
+ * \param[in]       argv: pointer array to token string
+ * \return          `1` if command is the built-in one, `0` otherwise
+ */
+static uint8_t prv_timing_command(microrl_t* mrl, uint8_t argc, const char* const* argv) {
+    microrl_timing_t* timing_arr = MICRORL_CONFIG(mrl)->timing_arr;
+    size_t table_len = prv_timing_table_len(mrl);
+
+    if (timing_arr == NULL || strcmp(argv[0], MICRORL_CFG_TIMING_CMD) != 0) {
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        memset(timing_arr, 0x00, (table_len + 1) * sizeof(microrl_timing_t));
+        return 1;
+    }
+
+    prv_terminal_write(mrl, "command           runs     max  histogram 2^N:runs, " MICRORL_CFG_TIMING_UNIT);
+    prv_terminal_newline(mrl);
+    for (size_t i = 0; i <= table_len; ++i) {
+        const microrl_timing_t* timing_ptr = &timing_arr[i];
+        const char* name_str = "(other)";
+        size_t len;
+
+        if (timing_ptr->count == 0) {
+            continue;
+        }
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE
+        if (i < table_len) {
+            name_str = MICRORL_CONFIG(mrl)->compl_table_ptr[i];
+        }
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE */
+        prv_terminal_write(mrl, name_str);
+        len = strlen(name_str);
+        prv_timing_print_num(mrl, timing_ptr->count, (len < 16) ? (22 - len) : 6);
+        prv_timing_print_num(mrl, timing_ptr->max, 8);
+        prv_terminal_write(mrl, " ");
+        for (size_t b = 0; b < MICRORL_CFG_TIMING_BUCKETS; ++b) {
+            if (timing_ptr->bucket_arr[b] != 0) {
+                char str[24] = " 2^";
+                char* str_ptr = prv_num_to_str(str + 3, (uint32_t)b);
+
+                *str_ptr++ = ':';
+                prv_num_to_str(str_ptr, timing_ptr->bucket_arr[b]);
+                prv_terminal_write(mrl, str);
+            }
+        }
+        prv_terminal_newline(mrl);
+    }
+
+    return 1;
+}
+#endif /* MICRORL_CFG_USE_TIMING || __DOXYGEN__ */
+
+/**
+ * \brief           Processing input string from command line and calling execute_fn() callback
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+MICRORL_CFG_STATIC_NOINLINE microrlr_t prv_handle_newline(microrl_t* mrl) {
+    const char* tkn_str_arr[MICRORL_CFG_CMD_TOKEN_NMB] = {0};
+    uint8_t tkn_cnt = 0;
+    microrlr_t status = microrlOK;
+
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+    prv_hint_erase(mrl);
+    mrl->hint_len = 0;                          /* The next line is suggested from the newest record */
+    mrl->hint_pos = MICRORL_CMDLINE_IDX_NONE;
+    mrl->hint_rec = 0;
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
+    prv_terminal_newline(mrl);
+#if MICRORL_CFG_USE_COMPLETE
+    prv_complete_erase_list(mrl);
+#endif /* MICRORL_CFG_USE_COMPLETE */
+
+    if (mrl->cmdlen == 0) {
+        goto exit;
+    }
+
+#if MICRORL_CFG_USE_HISTORY
+#if MICRORL_CFG_USE_ECHO_OFF
+    if (mrl->echo == MICRORL_ECHO_ON) {
+#endif /* MICRORL_CFG_USE_ECHO_OFF */
+        prv_hist_save_line(&mrl->ring_hist, mrl->cmdline_str, mrl->cmdlen);
+#if MICRORL_CFG_USE_ECHO_OFF
+    }
+#endif /* MICRORL_CFG_USE_ECHO_OFF */
+#endif /* MICRORL_CFG_USE_HISTORY */
+
+#if MICRORL_CFG_USE_ECHO_OFF
+    if ((mrl->echo == MICRORL_ECHO_ONCE) && (mrl->echo_off_pos != MICRORL_CMDLINE_IDX_NONE)
+            && (mrl->cmdline_str[mrl->echo_off_pos] != '\0')) {
+        microrl_set_echo(mrl, MICRORL_ECHO_ON);
+        mrl->echo_off_pos = MICRORL_CMDLINE_IDX_NONE;
+    }
+#endif /* MICRORL_CFG_USE_ECHO_OFF */
 
     status = prv_cmdline_buf_split(mrl, tkn_str_arr, &tkn_cnt, mrl->cmdlen);
     if (status == microrlOK) {
-#if MICRORL_CFG_USE_COMMAND_HOOKS
         int exec_status = 0;
 
+#if MICRORL_CFG_USE_TIMING
+        if (prv_timing_command(mrl, tkn_cnt, tkn_str_arr)) {
+            goto exit;
+        }
+#endif /* MICRORL_CFG_USE_TIMING */
+
+#if MICRORL_CFG_USE_COMMAND_HOOKS
         MICRORL_PRE_COMMAND_HOOK(mrl, tkn_cnt, tkn_str_arr);
+#endif /* MICRORL_CFG_USE_COMMAND_HOOKS */
+#if MICRORL_CFG_USE_TIMING
+        prv_timing_start(mrl, tkn_str_arr[0]);  /* Hooks aren't measured */
+#endif /* MICRORL_CFG_USE_TIMING */
+
+#if MICRORL_CFG_USE_EVENTS
+        if (MICRORL_CONFIG(mrl)->exec_fn == NULL) {
+            prv_event_raise(mrl, MICRORL_EVENT_LINE, tkn_cnt, tkn_str_arr);
+            return status;                      /* Line is kept until microrl_command_complete() */
+        }
+#endif /* MICRORL_CFG_USE_EVENTS */
 
-        exec_status = mrl->exec_fn(mrl, tkn_cnt, tkn_str_arr);
+        exec_status = MICRORL_CONFIG(mrl)->exec_fn(mrl, tkn_cnt, tkn_str_arr);
 
+#if MICRORL_CFG_USE_DEFERRED_EXEC
+        if (exec_status == MICRORL_EXEC_PENDING) {
+            mrl->exec_pending = 1;              /* Hook and prompt wait for microrl_command_complete() */
+            prv_cmdline_buf_reset(mrl);
+            return status;
+        }
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC */
+
+#if MICRORL_CFG_USE_TIMING
+        prv_timing_stop(mrl);
+#endif /* MICRORL_CFG_USE_TIMING */
+        MICRORL_UNUSED(exec_status);            /* Status is used only by post command hook */
+#if MICRORL_CFG_USE_COMMAND_HOOKS
         MICRORL_POST_COMMAND_HOOK(mrl, exec_status, tkn_cnt, tkn_str_arr);
-#else
-        mrl->exec_fn(mrl, tkn_cnt, tkn_str_arr);
 #endif /* MICRORL_CFG_USE_COMMAND_HOOKS */
     } else {
-        mrl->out_fn(mrl, "ERROR: too many tokens");
+        prv_terminal_write(mrl, "ERROR: too many tokens");
         prv_terminal_newline(mrl);
     }
 
@@ -693,40 +1425,487 @@ exit:
 #if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
 
 /**
- * \brief           Calculate total length of all completion tokens
- * \param[in]       arr: Completion tokens array
- * \return          Total length of all completion tokens
+ * \brief           Buffer to print completion candidates with as few output calls as possible
  */
-static size_t prv_complete_total_len(const char* const * argv) {
-    size_t i;
-    const char* short_str = (const char*)argv[0];
-    size_t shortlen = strlen(short_str);
+typedef struct {
+    char str[MICRORL_CFG_PRINT_BUFFER_LEN];         /*!< Buffered text */
+    size_t len;                                     /*!< Length of buffered text */
+} microrl_compl_print_buf_t;
 
-    for (i = 0; argv[i] != NULL; ++i) {
-        if (strlen(argv[i]) < shortlen) {
-            short_str = argv[i];
-            shortlen = strlen(short_str);
+/**
+ * \brief           Print buffered text and empty the buffer
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in,out]   buf_ptr: Pointer to \ref microrl_compl_print_buf_t structure
+ */
+static void prv_complete_print_flush(microrl_t* mrl, microrl_compl_print_buf_t* buf_ptr) {
+    if (buf_ptr->len != 0) {
+        buf_ptr->str[buf_ptr->len] = '\0';
+        prv_terminal_write(mrl, buf_ptr->str);
+        buf_ptr->len = 0;
+    }
+}
+
+/**
+ * \brief           Add text to the print buffer, or the character repeated, if text is NULL
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in,out]   buf_ptr: Pointer to \ref microrl_compl_print_buf_t structure
+ * \param[in]       text_str: Text to add, that may be not NULL-terminated, or NULL
+ * \param[in]       ch: Character to add, if text is NULL
+ * \param[in]       len: Length of text or number of characters to add
+ */
+static void prv_complete_print_add(microrl_t* mrl, microrl_compl_print_buf_t* buf_ptr,
+                                   const char* text_str, char ch, size_t len) {
+    while (len != 0) {
+        size_t part_len = MICRORL_ARRAYSIZE(buf_ptr->str) - 1 - buf_ptr->len;
+        if (part_len > len) {
+            part_len = len;
+        }
+
+        if (text_str != NULL) {
+            memcpy(buf_ptr->str + buf_ptr->len, text_str, part_len);
+            text_str += part_len;
+        } else {
+            memset(buf_ptr->str + buf_ptr->len, ch, part_len);
+        }
+        buf_ptr->len += part_len;
+        len -= part_len;
+
+        if (buf_ptr->len == (MICRORL_ARRAYSIZE(buf_ptr->str) - 1)) {
+            prv_complete_print_flush(mrl, buf_ptr);
         }
     }
+}
 
-    for (i = 0; i < shortlen; ++i) {
-        for (size_t j = 0; argv[j] != NULL; ++j) {
-            if (short_str[i] != argv[j][i]) {
-                return i;
+/**
+ * \brief           Get length of completion candidate
+ * \param[in]       cmplt_list_ptr: List of completion candidates
+ * \param[in]       idx: Index of candidate in list
+ * \return          Length of candidate
+ */
+MICRORL_CFG_STATIC_INLINE size_t prv_complete_cand_len(const microrl_compl_list_t* cmplt_list_ptr, size_t idx) {
+    if (cmplt_list_ptr->len_arr != NULL) {
+        return cmplt_list_ptr->len_arr[idx];
+    }
+    return strlen(cmplt_list_ptr->cmplt_arr[idx]);
+}
+
+/**
+ * \brief           Calculate length of prefix common to all completion candidates
+ *                      in a single pass through the list
+ * \param[in]       cmplt_list_ptr: List of completion candidates
+ * \return          Length of common prefix
+ */
+static size_t prv_complete_prefix_len(const microrl_compl_list_t* cmplt_list_ptr) {
+    const char* first_str = cmplt_list_ptr->cmplt_arr[0];
+    size_t prefix_len = prv_complete_cand_len(cmplt_list_ptr, 0);
+
+    for (size_t i = 1; (i < cmplt_list_ptr->count) && (prefix_len != 0); ++i) {
+        const char* str = cmplt_list_ptr->cmplt_arr[i];
+        size_t limit = prefix_len;
+        size_t j = 0;
+
+        if ((cmplt_list_ptr->len_arr != NULL) && (cmplt_list_ptr->len_arr[i] < limit)) {
+            limit = cmplt_list_ptr->len_arr[i];
+        }
+        while ((j < limit) && (first_str[j] == str[j])) {
+            ++j;
+        }
+        prefix_len = j;
+    }
+
+    return prefix_len;
+}
+
+/**
+ * \brief           Print completion candidates sorted down columns, which fit into
+ *                      \ref MICRORL_CFG_TERMINAL_WIDTH, below command line
+ *
+ * Cursor is returned back to command line after printing, so the line is not printed
+ * again. Candidates are left on screen until the line is executed.
+ *
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       cmplt_list_ptr: List of completion candidates
+ */
+static void prv_complete_print_list(microrl_t* mrl, const microrl_compl_list_t* cmplt_list_ptr) {
+    microrl_compl_print_buf_t buf;
+    char str[32] = "\033[";
+    size_t col_width = 0;
+
+    for (size_t i = 0; i < cmplt_list_ptr->count; ++i) {
+        size_t len = prv_complete_cand_len(cmplt_list_ptr, i);
+        if (len > col_width) {
+            col_width = len;
+        }
+    }
+    col_width += 2;                             /* Space between columns */
+
+    size_t cols = MICRORL_CFG_TERMINAL_WIDTH / col_width;
+    if (cols == 0) {
+        cols = 1;
+    }
+    size_t rows = (cmplt_list_ptr->count + cols - 1) / cols;
+
+    buf.len = 0;
+    for (size_t row = 0; row < rows; ++row) {
+        prv_complete_print_add(mrl, &buf, MICRORL_CFG_END_LINE, 0, sizeof(MICRORL_CFG_END_LINE) - 1);
+        if (row == 0) {
+            prv_complete_print_add(mrl, &buf, "\033[J", 0, 3);  /* Erase previously printed candidates */
+        }
+        for (size_t i = row; i < cmplt_list_ptr->count; i += rows) {
+            size_t len = prv_complete_cand_len(cmplt_list_ptr, i);
+            prv_complete_print_add(mrl, &buf, cmplt_list_ptr->cmplt_arr[i], 0, len);
+            if ((i + rows) < cmplt_list_ptr->count) {
+                prv_complete_print_add(mrl, &buf, NULL, ' ', col_width - len);
             }
         }
     }
 
-    return i;
+    char* str_ptr = prv_num_to_str(str + 2, (uint32_t)rows);   /* Move cursor up to command line */
+    *str_ptr++ = 'A';
+    str_ptr = prv_cursor_generate_line_pos(mrl, str_ptr, mrl->cursor);
+    prv_complete_print_add(mrl, &buf, str, 0, (size_t)(str_ptr - str));
+    prv_complete_print_flush(mrl, &buf);
+    mrl->compl_list_shown = 1;
+}
+
+
+#if MICRORL_CFG_USE_COMPLETE_TABLE || __DOXYGEN__
+/**
+ * \brief           Find commands starting with the passed token in the sorted completion table
+ *
+ * Matching commands form a contiguous range of the sorted table, which bounds are found
+ * by binary search. Prefix common to the whole range is the prefix common to its
+ * first and last commands.
+ *
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       tkn_str: Token to complete
+ * \param[in]       tkn_len: Length of token to complete
+ * \param[out]      cmplt_list_ptr: Set of matching commands
+ */
+static void prv_complete_table_lookup(microrl_t* mrl, const char* tkn_str, size_t tkn_len,
+                                      microrl_compl_list_t* cmplt_list_ptr) {
+    const char* const* table_ptr = MICRORL_CONFIG(mrl)->compl_table_ptr;
+    size_t table_len = MICRORL_CONFIG(mrl)->compl_table_len;
+    size_t lo = 0;
+    size_t hi = table_len;
+
+    while (lo < hi) {                           /* Find first command not less than token */
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(table_ptr[mid], tkn_str, tkn_len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    size_t first = lo;
+    hi = table_len;
+    while (lo < hi) {                           /* Find first command greater than token */
+        size_t mid = lo + (hi - lo) / 2;
+        if (strncmp(table_ptr[mid], tkn_str, tkn_len) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    cmplt_list_ptr->cmplt_arr = table_ptr + first;
+    cmplt_list_ptr->count = lo - first;
+    cmplt_list_ptr->prefix_len = 0;
+    if (cmplt_list_ptr->count != 0) {
+        const char* first_str = table_ptr[first];
+        const char* last_str = table_ptr[lo - 1];
+        while ((first_str[cmplt_list_ptr->prefix_len] != '\0')
+                && (first_str[cmplt_list_ptr->prefix_len] == last_str[cmplt_list_ptr->prefix_len])) {
+            ++cmplt_list_ptr->prefix_len;
+        }
+    }
+}
+#endif /* MICRORL_CFG_USE_COMPLETE_TABLE || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_COMPLETE_FUZZY || __DOXYGEN__
+/**
+ * \brief           Convert ASCII character to lower case
+ * \param[in]       ch: Character to convert
+ * \return          Lower case character
+ */
+MICRORL_CFG_STATIC_INLINE char prv_complete_fuzzy_fold(char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? (char)(ch - 'A' + 'a') : ch;
+}
+
+/**
+ * \brief           Score candidate matching pattern as case-insensitive subsequence
+ *
+ * Characters are matched greedily left to right in a single pass over candidate,
+ * so the cost is bounded by the candidate length and no memory is needed.
+ *
+ * \param[in]       pattern_str: Pattern to match
+ * \param[in]       pattern_len: Length of pattern
+ * \param[in]       cand_str: NULL-terminated candidate
+ * \return          Score of candidate, higher is better, or \ref MICRORL_FUZZY_NO_MATCH
+ */
+static int32_t prv_complete_fuzzy_score(const char* pattern_str, size_t pattern_len, const char* cand_str) {
+    int32_t score = 0;
+    size_t matched = 0;
+    uint8_t prev_matched = 0;
+    char prev_ch = '\0';
+
+    for (size_t i = 0; (cand_str[i] != '\0') && (matched < pattern_len); ++i) {
+        char ch = cand_str[i];
+
+        if (prv_complete_fuzzy_fold(ch) == prv_complete_fuzzy_fold(pattern_str[matched])) {
+            score += MICRORL_FUZZY_SCORE_MATCH;
+            if (prev_matched) {
+                score += MICRORL_FUZZY_BONUS_CONTIGUOUS;
+            }
+            if ((i == 0) || (prev_ch == '_') || (prev_ch == '-') || (prev_ch == '.') || (prev_ch == '/')
+                    || ((prev_ch >= 'a' && prev_ch <= 'z') && (ch >= 'A' && ch <= 'Z'))) {
+                score += MICRORL_FUZZY_BONUS_WORD_START;
+            }
+            ++matched;
+            prev_matched = 1;
+        } else {
+            score -= MICRORL_FUZZY_PENALTY_GAP;
+            prev_matched = 0;
+        }
+        prev_ch = ch;
+    }
+
+    return (matched == pattern_len) ? score : MICRORL_FUZZY_NO_MATCH;
+}
+
+/**
+ * \brief           Find candidates containing pattern as subsequence and rank them by score
+ *
+ * Candidates with equal score keep their order in `cand_arr`. No memory is allocated,
+ * scores of ranked candidates are kept on stack.
+ *
+ * \param[in]       pattern_str: Pattern to match, may be not NULL-terminated
+ * \param[in]       pattern_len: Length of pattern
+ * \param[in]       cand_arr: Array of NULL-terminated candidates
+ * \param[in]       cand_cnt: Number of candidates
+ * \param[out]      top_arr: Array to save best candidates to, in descending order of score
+ * \param[in]       top_k: Size of `top_arr`, limited to \ref MICRORL_CFG_COMPL_FUZZY_TOP_K
+ * \return          Number of candidates saved to `top_arr`
+ */
+size_t microrl_complete_fuzzy(const char* pattern_str, size_t pattern_len, const char* const* cand_arr,
+                              size_t cand_cnt, const char** top_arr, size_t top_k) {
+    int32_t score_arr[MICRORL_CFG_COMPL_FUZZY_TOP_K];
+    size_t top_cnt = 0;
+
+    if (pattern_str == NULL || cand_arr == NULL || top_arr == NULL) {
+        return 0;
+    }
+    if (top_k > MICRORL_CFG_COMPL_FUZZY_TOP_K) {
+        top_k = MICRORL_CFG_COMPL_FUZZY_TOP_K;
+    }
+
+    for (size_t i = 0; i < cand_cnt; ++i) {
+        int32_t score = prv_complete_fuzzy_score(pattern_str, pattern_len, cand_arr[i]);
+
+        if ((score == MICRORL_FUZZY_NO_MATCH)
+                || ((top_cnt == top_k) && (top_k != 0) && (score <= score_arr[top_k - 1]))) {
+            continue;
+        }
+        if (top_k == 0) {
+            break;
+        }
+
+        size_t j = (top_cnt < top_k) ? top_cnt++ : (top_k - 1);
+        for (; (j > 0) && (score_arr[j - 1] < score); --j) {
+            score_arr[j] = score_arr[j - 1];    /* Shift worse candidates down */
+            top_arr[j] = top_arr[j - 1];
+        }
+        score_arr[j] = score;
+        top_arr[j] = cand_arr[i];
+    }
+
+    return top_cnt;
+}
+#endif /* MICRORL_CFG_USE_COMPLETE_FUZZY || __DOXYGEN__ */
+
+/**
+ * \brief           Complete the token ending at passed position with candidates
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       cmplt_list_ptr: Completion candidates
+ * \param[in]       tkn_end: End position of the token containing the cursor
+ * \param[in]       tkn_len: Length of the token
+ * \param[in]       query: Ask before printing more than \ref MICRORL_CFG_COMPL_QUERY_ITEMS candidates
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+MICRORL_CFG_STATIC_NOINLINE microrlr_t prv_complete_apply(microrl_t* mrl, const microrl_compl_list_t* cmplt_list_ptr,
+                                                          size_t tkn_end, size_t tkn_len, uint8_t query) {
+    microrl_compl_list_t cmplt_list = *cmplt_list_ptr;
+    size_t term_cursor = mrl->cursor;           /* Cursor position on terminal */
+
+    /* Restore whitespaces replaced with '0' when command line buffer was split */
+    for (size_t i = 0; i < mrl->cmdlen; ++i) {
+        if (mrl->cmdline_str[i] == '\0') {
+            mrl->cmdline_str[i] = ' ';
+        }
+    }
+
+    if (cmplt_list.count == 0) {
+        return microrlERRCPLT;
+    }
+
+    size_t len;
+    size_t pos = tkn_end;                       /* Start position of changed part of line */
+    size_t cmdlen = mrl->cmdlen;
+
+    mrl->cursor = tkn_end;
+
+    if (cmplt_list.count == 1) {
+        len = prv_complete_cand_len(&cmplt_list, 0);
+    } else {
+        len = cmplt_list.prefix_len;
+        if (len == MICRORL_COMPL_PREFIX_UNKNOWN) {
+            len = prv_complete_prefix_len(&cmplt_list);
+        }
+    }
+
+    if ((len >= tkn_len) && (memcmp(cmplt_list.cmplt_arr[0], mrl->cmdline_str + pos - tkn_len, tkn_len) == 0)) {
+        if (len > tkn_len) {                    /* Candidates extend the token */
+            prv_cmdline_buf_insert_text(mrl, cmplt_list.cmplt_arr[0] + tkn_len, len - tkn_len);
+        }
+    } else if (cmplt_list.count == 1) {         /* Candidate doesn't start with the token, e.g. fuzzy match */
+        if ((mrl->cmdlen - tkn_len + len) <= (MICRORL_ARRAYSIZE(mrl->cmdline_str) - 1)) {
+            prv_cmdline_buf_backspace(mrl, tkn_len);
+            pos -= tkn_len;
+            prv_cmdline_buf_insert_text(mrl, cmplt_list.cmplt_arr[0], len);
+            cmdlen = (size_t)-1;                /* Line is changed even if length is the same */
+        }
+    }
+
+    if (cmplt_list.count == 1) {
+        if (mrl->cmdline_str[mrl->cursor] == ' ') {
+            ++mrl->cursor;                      /* Step over space already following the token */
+        } else {
+            prv_cmdline_buf_insert_text(mrl, " ", 1);   /* Insert end space if completion is performed */
+        }
+    }
+
+    if (cmdlen != mrl->cmdlen) {
+        prv_terminal_move_cursor(mrl, (int32_t)pos - (int32_t)term_cursor);
+        prv_terminal_print_line(mrl, pos, 0);
+    } else {
+        prv_terminal_move_cursor(mrl, (int32_t)mrl->cursor - (int32_t)term_cursor);
+    }
+
+    if (cmplt_list.count > 1) {
+#if MICRORL_CFG_USE_COMPLETE_CYCLE
+        mrl->cycle_arr = cmplt_list.cmplt_arr;  /* Cache candidates for the next 'Tab' */
+        mrl->cycle_len_arr = cmplt_list.len_arr;
+        mrl->cycle_cnt = cmplt_list.count;
+        mrl->cycle_idx = 0;
+        mrl->cycle_pos = tkn_end - tkn_len;
+#endif /* MICRORL_CFG_USE_COMPLETE_CYCLE */
+#if MICRORL_CFG_COMPL_QUERY_ITEMS > 0
+        if (query && (cmplt_list.count > MICRORL_CFG_COMPL_QUERY_ITEMS)) {
+            char str[sizeof(MICRORL_CFG_END_LINE) + 28] = MICRORL_CFG_END_LINE "\033[JDisplay all ";
+
+            prv_num_to_str(str + strlen(str), (uint32_t)cmplt_list.count);
+            prv_terminal_write(mrl, str);
+            prv_terminal_write(mrl, " possibilities? (y/n)");
+            mrl->compl_query = 1;
+            return microrlOK;                   /* Cursor is returned to command line after answer */
+        }
+#else
+        MICRORL_UNUSED(query);
+#endif /* MICRORL_CFG_COMPL_QUERY_ITEMS > 0 */
+        prv_complete_print_list(mrl, &cmplt_list);
+    }
+
+    return microrlOK;
+}
+
+/**
+ * \brief           Split command line up to the end of the token containing the cursor
+ *                      and get completion candidates for it.
+ *                      Token array is on stack only here, not while candidates are printed
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[out]      cmplt_list_ptr: Pointer to \ref microrl_compl_list_t structure to get candidates to
+ * \param[out]      tkn_end_ptr: End position of the token containing the cursor
+ * \param[out]      tkn_len_ptr: Length of the token containing the cursor
+ * \return          `1` if candidates must be applied, `0` if they are passed later with completion event
+ */
+MICRORL_CFG_STATIC_NOINLINE uint8_t prv_complete_get_list(microrl_t* mrl, microrl_compl_list_t* cmplt_list_ptr,
+                                                          size_t* tkn_end_ptr, size_t* tkn_len_ptr) {
+    const microrl_config_t* cfg = MICRORL_CONFIG(mrl);
+    uint8_t tkn_cnt = 0;
+    const char* tkn_str_arr[MICRORL_CFG_CMD_TOKEN_NMB + 1] = {0};
+    size_t tkn_end = mrl->cursor;
+
+    while ((tkn_end < mrl->cmdlen) && (mrl->cmdline_str[tkn_end] != ' ')) {
+        ++tkn_end;                              /* Find end of token under cursor */
+    }
+
+    *tkn_end_ptr = tkn_end;
+    *tkn_len_ptr = 0;
+    if (prv_cmdline_buf_split(mrl, tkn_str_arr, &tkn_cnt, tkn_end) != microrlOK) {
+        return 1;
+    }
+
+    if ((tkn_end == 0) || (mrl->cmdline_str[tkn_end - 1] == '\0')) {
+        /* Last char is whitespace */
+        if (tkn_cnt == MICRORL_CFG_CMD_TOKEN_NMB) {
+            return 1;                           /* No room for a new token */
+        }
+        tkn_str_arr[tkn_cnt++] = "";
+        tkn_str_arr[tkn_cnt] = NULL;
+    }
+
+    size_t tkn_len = strlen(tkn_str_arr[tkn_cnt - 1]);
+    *tkn_len_ptr = tkn_len;
+
+#if MICRORL_CFG_USE_COMPLETE_TABLE
+    if ((tkn_cnt == 1) && (cfg->compl_table_ptr != NULL)) {
+        prv_complete_table_lookup(mrl, tkn_str_arr[0], tkn_len, cmplt_list_ptr);
+#if MICRORL_CFG_USE_COMPLETE_FUZZY
+        if ((cmplt_list_ptr->count == 0) && (tkn_len != 0)) {
+            cmplt_list_ptr->cmplt_arr = mrl->compl_fuzzy_arr;
+            cmplt_list_ptr->count = microrl_complete_fuzzy(tkn_str_arr[0], tkn_len, cfg->compl_table_ptr,
+                                                           cfg->compl_table_len, mrl->compl_fuzzy_arr,
+                                                           MICRORL_CFG_COMPL_FUZZY_TOP_K);
+            cmplt_list_ptr->prefix_len = MICRORL_COMPL_PREFIX_UNKNOWN;
+        }
+#endif /* MICRORL_CFG_USE_COMPLETE_FUZZY */
+    } else
+#endif /* MICRORL_CFG_USE_COMPLETE_TABLE */
+    if (cfg->get_compl_list_fn != NULL) {
+        cfg->get_compl_list_fn(mrl, tkn_cnt, tkn_str_arr, cmplt_list_ptr);
+    } else if (cfg->get_completion_fn != NULL) {
+        char** cmplt_tkn_arr = cfg->get_completion_fn(mrl, tkn_cnt, tkn_str_arr);
+
+        cmplt_list_ptr->cmplt_arr = (const char* const *)cmplt_tkn_arr;
+        while (cmplt_tkn_arr[cmplt_list_ptr->count] != NULL) {
+            ++cmplt_list_ptr->count;
+        }
+    }
+#if MICRORL_CFG_USE_EVENTS
+    else {                                      /* Candidates are passed with microrl_complete_answer() */
+        prv_event_raise(mrl, MICRORL_EVENT_COMPLETE, tkn_cnt, tkn_str_arr);
+        mrl->evt_tkn_end = tkn_end;
+        return 0;
+    }
+#endif /* MICRORL_CFG_USE_EVENTS */
+
+    return 1;
 }
 
 /**
- * \brief           Auto-complete activities to complete input in
- *                      command line
+ * \brief           Get input for completion: split command line up to the end of the token
+ *                      containing the cursor, then get candidates and complete it
+ *
+ * The whole token containing the cursor is completed, even if the cursor is in the middle
+ * of it. Command line is redrawn only from the token start, or from its end if the token
+ * is extended, and candidates are printed below command line without printing it again.
+ *
  * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       query: Ask before printing more than \ref MICRORL_CFG_COMPL_QUERY_ITEMS candidates
  * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
  */
-static microrlr_t prv_complete_get_input(microrl_t* mrl) {
+static microrlr_t prv_complete_get_input(microrl_t* mrl, uint8_t query) {
     /* Skip completion when echo is OFF */
 #if MICRORL_CFG_USE_ECHO_OFF
     if (mrl->echo != MICRORL_ECHO_ON) {
@@ -734,84 +1913,273 @@ static microrlr_t prv_complete_get_input(microrl_t* mrl) {
     }
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
 
-    uint8_t tkn_cnt = 0;
-    const char* tkn_str_arr[MICRORL_CFG_CMD_TOKEN_NMB] = {0};
-    char** cmplt_tkn_arr;
+    MICRORL_STATS_ADD(mrl, completions, 1);
+    microrl_compl_list_t cmplt_list = {NULL, NULL, 0, MICRORL_COMPL_PREFIX_UNKNOWN};
+    size_t tkn_end;
+    size_t tkn_len;
 
-    if (prv_cmdline_buf_split(mrl, tkn_str_arr, &tkn_cnt, mrl->cursor) != microrlOK) {
-        return microrlERRCPLT;
+    if (!prv_complete_get_list(mrl, &cmplt_list, &tkn_end, &tkn_len)) {
+#if MICRORL_CFG_USE_EVENTS
+        mrl->evt_query = query;                 /* Candidates are passed with microrl_complete_answer() */
+#endif /* MICRORL_CFG_USE_EVENTS */
+        return microrlOK;
     }
+    return prv_complete_apply(mrl, &cmplt_list, tkn_end, tkn_len, query);
+}
 
-    if (mrl->cmdline_str[mrl->cursor - 1] == '\0') {
-        /* Last char is whitespace */
-        tkn_str_arr[tkn_cnt++] = "";
-        tkn_str_arr[tkn_cnt] = NULL;
+#if MICRORL_CFG_USE_COMPLETE_CYCLE || __DOXYGEN__
+/**
+ * \brief           Replace the token being completed with the next cached candidate
+ *                      and redraw command line from the token start
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ */
+static void prv_complete_cycle(microrl_t* mrl) {
+    const char* cand_str = mrl->cycle_arr[mrl->cycle_idx];
+    size_t cand_len = (mrl->cycle_len_arr != NULL) ? mrl->cycle_len_arr[mrl->cycle_idx] : strlen(cand_str);
+    size_t cursor = mrl->cursor;
+
+    if (++mrl->cycle_idx == mrl->cycle_cnt) {
+        mrl->cycle_idx = 0;
     }
 
-    cmplt_tkn_arr = mrl->get_completion_fn(mrl, tkn_cnt, tkn_str_arr);
-    if (cmplt_tkn_arr[0] == NULL) {
-        return microrlERRCPLT;
+    if ((mrl->cmdlen - (cursor - mrl->cycle_pos) + cand_len) > MICRORL_CFG_CMDLINE_LEN) {
+        return;                                 /* Candidate doesn't fit into command line */
     }
 
-    size_t i = 0;
-    size_t len;
-    size_t pos = mrl->cursor;
+    prv_cmdline_buf_backspace(mrl, cursor - mrl->cycle_pos);
+    prv_cmdline_buf_insert_text(mrl, cand_str, cand_len);
+    prv_terminal_move_cursor(mrl, (int32_t)mrl->cycle_pos - (int32_t)cursor);
+    prv_terminal_print_line(mrl, mrl->cycle_pos, 0);
+}
+#endif /* MICRORL_CFG_USE_COMPLETE_CYCLE || __DOXYGEN__ */
 
-    if (cmplt_tkn_arr[1] == NULL) {
-        len = strlen(cmplt_tkn_arr[0]);
-    } else {
-        len = prv_complete_total_len((const char* const *)cmplt_tkn_arr);
-        prv_terminal_newline(mrl);
-        while (cmplt_tkn_arr[i] != NULL) {
-            mrl->out_fn(mrl, cmplt_tkn_arr[i]);
-            mrl->out_fn(mrl, " ");
-            ++i;
+#if (MICRORL_CFG_COMPL_QUERY_ITEMS > 0) || __DOXYGEN__
+/**
+ * \brief           Process answer to print all completion candidates
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       ch: Answer character
+ */
+static void prv_complete_query_answer(microrl_t* mrl, char ch) {
+    char str[24] = "\r\033[K\033[A";           /* Erase the question and return to command line */
+
+    prv_cursor_generate_line_pos(mrl, str + 7, mrl->cursor);
+    prv_terminal_write(mrl, str);
+    mrl->compl_query = 0;
+    if ((ch == 'y') || (ch == 'Y') || (ch == ' ')) {
+        prv_complete_get_input(mrl, 0);
+    }
+}
+#endif /* (MICRORL_CFG_COMPL_QUERY_ITEMS > 0) || __DOXYGEN__ */
+
+#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_PROMPT_COLOR
+/**
+ * \brief           Calculate prompt size excluding ANSI escape sequences
+ * \param[in]       prompt_str: Pointer to prompt string
+ * \return          Size of prompt string excluding ANSI escape sequences
+ */
+static size_t prv_calculate_prompt_size(const char* prompt_str) {
+    size_t size = 0;
+    const char* ptr = prompt_str;
+
+    while (*ptr != '\0') {
+        if (*ptr == '\033') {                 // Check for ANSI escape code
+            while (*ptr != 'm' && *ptr != '\0') {
+                ++ptr;                        // Skip ANSI escape code
+            }
+            if (*ptr == 'm') {
+                ++ptr;                        // Move past 'm'
+            }
+        } else {
+            ++size;                           // Count regular character
+            ++ptr;
         }
-        prv_terminal_newline(mrl);
-        prv_terminal_print_prompt(mrl);
-        pos = 0;
     }
 
-    if (len != 0) {
-        prv_cmdline_buf_insert_text(mrl, cmplt_tkn_arr[0] + strlen(tkn_str_arr[tkn_cnt - 1]),
-                                    len - strlen(tkn_str_arr[tkn_cnt - 1]));
+    return size;
+}
+#endif
+
+/**
+ * \brief           Initialize microRL configuration with default prompt and no optional callbacks
+ * \param[out]      cfg: Configuration to initialize
+ * \param[in]       out_fn: Output function used for print operation, or NULL with \ref MICRORL_CFG_OUT_FN
+ * \param[in]       exec_fn: Command execute callback function, or NULL to poll \ref MICRORL_EVENT_LINE
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_init(microrl_config_t* cfg, microrl_output_fn out_fn, microrl_exec_fn exec_fn) {
+    if (cfg == NULL || MICRORL_OUT_FN_INVALID(out_fn) || MICRORL_EXEC_FN_INVALID(exec_fn)) {
+        return microrlERRPAR;
     }
 
-    /* Insert end space if completion is performed */
-    if (cmplt_tkn_arr[1] == NULL) {
-        prv_cmdline_buf_insert_text(mrl, " ", 1);
+    memset(cfg, 0x00, sizeof(microrl_config_t));
+    cfg->out_fn = out_fn;
+    cfg->exec_fn = exec_fn;
+
+    return microrl_config_set_prompt(cfg, MICRORL_CFG_PROMPT_STRING);
+}
+
+/**
+ * \brief           Set pointer to command execute callback, that called when user press 'Enter'
+ * \param[in,out]   cfg: \ref microrl_config_t configuration
+ * \param[in]       exec_fn: Command execute callback, or NULL to poll \ref MICRORL_EVENT_LINE
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_set_execute_callback(microrl_config_t* cfg, microrl_exec_fn exec_fn) {
+    if (cfg == NULL || MICRORL_EXEC_FN_INVALID(exec_fn)) {
+        return microrlERRPAR;
     }
 
-    /* Restore whitespaces replaced with '0' when command line buffer was split */
-    if (tkn_cnt != 0) {
-        for (size_t i = 0; i < (size_t)(tkn_cnt - 1); ++i) {
-            memset((char*)tkn_str_arr[i] + strlen(tkn_str_arr[i]), ' ', 1);
-        }
+    cfg->exec_fn = exec_fn;
+
+    return microrlOK;
+}
+
+#if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
+/**
+ * \brief           Set pointer to input complition callback, that called when user press 'Tab'
+ * \param[in,out]   cfg: \ref microrl_config_t configuration
+ * \param[in]       get_completion_fn: Auto-complete input string callback
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_set_complete_callback(microrl_config_t* cfg, microrl_get_compl_fn get_completion_fn) {
+    if (cfg == NULL || get_completion_fn == NULL) {
+        return microrlERRPAR;
     }
 
-    prv_terminal_print_line(mrl, pos, 0);
+    cfg->get_completion_fn = get_completion_fn;
 
     return microrlOK;
 }
 
+/**
+ * \brief           Set pointer to input completion callback returning counted list of candidates,
+ *                      that called when user press 'Tab'. It's used instead of callback set by
+ *                      \ref microrl_config_set_complete_callback
+ * \param[in,out]   cfg: \ref microrl_config_t configuration
+ * \param[in]       get_compl_list_fn: Auto-complete input string callback
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_set_complete_list_callback(microrl_config_t* cfg, microrl_get_compl_list_fn get_compl_list_fn) {
+    if (cfg == NULL || get_compl_list_fn == NULL) {
+        return microrlERRPAR;
+    }
+
+    cfg->get_compl_list_fn = get_compl_list_fn;
+
+    return microrlOK;
+}
 #endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
 
+#if (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE) || __DOXYGEN__
 /**
- * \brief           Initialize microRL instance
+ * \brief           Set sorted table of commands used to complete command name, when user press 'Tab'
+ *
+ * Table must be sorted in ascending order as by `strcmp()` and stay valid while it is used.
+ * Arguments of the command are still completed by the completion callback, if it's set.
+ *
+ * \param[in,out]   cfg: \ref microrl_config_t configuration
+ * \param[in]       table_ptr: Sorted table of command names
+ * \param[in]       table_len: Number of commands in table
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_set_complete_table(microrl_config_t* cfg, const char* const* table_ptr, size_t table_len) {
+    if (cfg == NULL || table_ptr == NULL) {
+        return microrlERRPAR;
+    }
+
+    cfg->compl_table_ptr = table_ptr;
+    cfg->compl_table_len = table_len;
+
+    return microrlOK;
+}
+#endif /* (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE) || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_CTRL_C || __DOXYGEN__
+/**
+ * \brief           Set callback for Ctrl+C terminal signal
+ * \param[in,out]   cfg: \ref microrl_config_t configuration
+ * \param[in]       sigint_fn: Ctrl+C terminal signal callback
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_set_sigint_callback(microrl_config_t* cfg, microrl_sigint_fn sigint_fn) {
+    if (cfg == NULL || sigint_fn == NULL) {
+        return microrlERRPAR;
+    }
+
+    cfg->sigint_fn = sigint_fn;
+
+    return microrlOK;
+}
+#endif /* MICRORL_CFG_USE_CTRL_C || __DOXYGEN__ */
+
+/**
+ * \brief           Set prompt string
+ * \param[in,out]   cfg: \ref microrl_config_t configuration
+ * \param[in]       prompt_str: Pointer to prompt string to set
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_set_prompt(microrl_config_t* cfg, char* prompt_str) {
+    if (cfg == NULL || prompt_str == NULL) {
+        return microrlERRPAR;
+    }
+
+    cfg->prompt_ptr = prompt_str;
+#if MICRORL_CFG_USE_PROMPT_COLOR
+    cfg->prompt_size = prv_calculate_prompt_size(prompt_str);
+#else
+    cfg->prompt_size = strlen(prompt_str);
+#endif
+
+    return microrlOK;
+}
+
+#if MICRORL_CFG_USE_TIMING || __DOXYGEN__
+/**
+ * \brief           Set histograms to collect execution time of commands to
+ *
+ * Array must have one histogram per command of completion table, in the same order,
+ * and one more for other commands. Without completion table all commands share the only histogram.
+ * Array is written by all instances sharing the configuration and must stay valid while it is used.
+ *
+ * \param[in,out]   cfg: \ref microrl_config_t configuration
+ * \param[in]       timing_arr: Zero-initialized array of histograms
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_config_set_timing(microrl_config_t* cfg, microrl_timing_t* timing_arr) {
+    if (cfg == NULL || timing_arr == NULL) {
+        return microrlERRPAR;
+    }
+
+    cfg->timing_arr = timing_arr;
+
+    return microrlOK;
+}
+#endif /* MICRORL_CFG_USE_TIMING || __DOXYGEN__ */
+
+/**
+ * \brief           Initialize microRL instance with configuration.
+ *
+ * With \ref MICRORL_CFG_USE_SHARED_CONFIG enabled, instance keeps the pointer to configuration,
+ * so it must stay valid and unchanged while the instance is used. Otherwise it's copied to instance.
+ *
  * \param[in,out]   mrl: microRL working instance
- * \param[in]       out_fn: Output function used for print operation
- * \brief           exec_fn: Command execute callback function
+ * \param[in]       cfg_ptr: Configuration initialized by \ref microrl_config_init
  * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
  */
-microrlr_t microrl_init(microrl_t* mrl, microrl_output_fn out_fn, microrl_exec_fn exec_fn) {
-    if (mrl == NULL || out_fn == NULL || exec_fn == NULL) {
+microrlr_t microrl_init_shared(microrl_t* mrl, const microrl_config_t* cfg_ptr) {
+    if (mrl == NULL || cfg_ptr == NULL || MICRORL_OUT_FN_INVALID(cfg_ptr->out_fn)
+            || MICRORL_EXEC_FN_INVALID(cfg_ptr->exec_fn) || cfg_ptr->prompt_ptr == NULL) {
         return microrlERRPAR;
     }
 
     memset(mrl, 0x00, sizeof(microrl_t));
-    mrl->out_fn = out_fn;
-    mrl->exec_fn = exec_fn;
-    microrl_set_prompt(mrl, MICRORL_CFG_PROMPT_STRING);
+#if MICRORL_CFG_USE_SHARED_CONFIG
+    mrl->cfg_ptr = cfg_ptr;
+#else
+    mrl->cfg = *cfg_ptr;
+#endif /* MICRORL_CFG_USE_SHARED_CONFIG */
 
 #if MICRORL_CFG_PROMPT_ON_INIT
     prv_terminal_print_prompt(mrl);
@@ -819,12 +2187,36 @@ microrlr_t microrl_init(microrl_t* mrl, microrl_output_fn out_fn, microrl_exec_f
 
 #if MICRORL_CFG_USE_ECHO_OFF
     mrl->echo = MICRORL_ECHO_ON;
-    mrl->echo_off_pos = -1;
+    mrl->echo_off_pos = MICRORL_CMDLINE_IDX_NONE;
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
 
+#if MICRORL_CFG_USE_ASYNC_PRINT
+    for (size_t i = 0; i < MICRORL_CFG_ASYNC_PRINT_MSG_NUM; ++i) {
+        mrl->async_queue.msg_arr[i].seq = (uint8_t)i;   /* Message is free for producer at position 'i' */
+    }
+#endif /* MICRORL_CFG_USE_ASYNC_PRINT */
+
     return microrlOK;
 }
 
+#if !MICRORL_CFG_USE_SHARED_CONFIG || __DOXYGEN__
+/**
+ * \brief           Initialize microRL instance
+ * \param[in,out]   mrl: microRL working instance
+ * \param[in]       out_fn: Output function used for print operation, or NULL with \ref MICRORL_CFG_OUT_FN
+ * \param[in]       exec_fn: Command execute callback function
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_init(microrl_t* mrl, microrl_output_fn out_fn, microrl_exec_fn exec_fn) {
+    microrl_config_t cfg;
+
+    if (mrl == NULL || microrl_config_init(&cfg, out_fn, exec_fn) != microrlOK) {
+        return microrlERRPAR;
+    }
+
+    return microrl_init_shared(mrl, &cfg);
+}
+
 /**
  * \brief           Set pointer to command execute callback, that called when user press 'Enter'
  * \param[in,out]   mrl: \ref microrl_t working instance
@@ -832,13 +2224,11 @@ microrlr_t microrl_init(microrl_t* mrl, microrl_output_fn out_fn, microrl_exec_f
  * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
  */
 microrlr_t microrl_set_execute_callback(microrl_t* mrl, microrl_exec_fn exec_fn) {
-    if (mrl == NULL || exec_fn == NULL) {
+    if (mrl == NULL) {
         return microrlERRPAR;
     }
 
-    mrl->exec_fn = exec_fn;
-
-    return microrlOK;
+    return microrl_config_set_execute_callback(&mrl->cfg, exec_fn);
 }
 
 #if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
@@ -849,62 +2239,63 @@ microrlr_t microrl_set_execute_callback(microrl_t* mrl, microrl_exec_fn exec_fn)
  * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
  */
 microrlr_t microrl_set_complete_callback(microrl_t* mrl, microrl_get_compl_fn get_completion_fn) {
-    if (mrl == NULL || get_completion_fn == NULL) {
+    if (mrl == NULL) {
         return microrlERRPAR;
     }
 
-    mrl->get_completion_fn = get_completion_fn;
-
-    return microrlOK;
+    return microrl_config_set_complete_callback(&mrl->cfg, get_completion_fn);
 }
-#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
 
-#if MICRORL_CFG_USE_CTRL_C || __DOXYGEN__
 /**
- * \brief           Set callback for Ctrl+C terminal signal
+ * \brief           Set pointer to input completion callback returning counted list of candidates,
+ *                      that called when user press 'Tab'. It's used instead of callback set by
+ *                      \ref microrl_set_complete_callback
  * \param[in,out]   mrl: \ref microrl_t working instance
- * \param[in]       sigint_fn: Ctrl+C terminal signal callback
+ * \param[in]       get_compl_list_fn: Auto-complete input string callback
  * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
  */
-microrlr_t microrl_set_sigint_callback(microrl_t* mrl, microrl_sigint_fn sigint_fn) {
-    if (mrl == NULL || sigint_fn == NULL) {
+microrlr_t microrl_set_complete_list_callback(microrl_t* mrl, microrl_get_compl_list_fn get_compl_list_fn) {
+    if (mrl == NULL) {
         return microrlERRPAR;
     }
 
-    mrl->sigint_fn = sigint_fn;
-
-    return microrlOK;
+    return microrl_config_set_complete_list_callback(&mrl->cfg, get_compl_list_fn);
 }
-#endif /* MICRORL_CFG_USE_CTRL_C || __DOXYGEN__ */
-
+#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
 
-#if MICRORL_CFG_USE_PROMPT_COLOR
+#if (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE) || __DOXYGEN__
 /**
- * \brief           Calculate prompt size excluding ANSI escape sequences
- * \param[in]       prompt_str: Pointer to prompt string
- * \return          Size of prompt string excluding ANSI escape sequences
+ * \brief           Set sorted table of commands used to complete command name, when user press 'Tab'
+ * \note            See \ref microrl_config_set_complete_table for table requirements
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       table_ptr: Sorted table of command names
+ * \param[in]       table_len: Number of commands in table
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
  */
-static size_t prv_calculate_prompt_size(const char* prompt_str) {
-    size_t size = 0;
-    const char* ptr = prompt_str;
+microrlr_t microrl_set_complete_table(microrl_t* mrl, const char* const* table_ptr, size_t table_len) {
+    if (mrl == NULL) {
+        return microrlERRPAR;
+    }
 
-    while (*ptr != '\0') {
-        if (*ptr == '\033') {                 // Check for ANSI escape code
-            while (*ptr != 'm' && *ptr != '\0') {
-                ++ptr;                        // Skip ANSI escape code
-            }
-            if (*ptr == 'm') {
-                ++ptr;                        // Move past 'm'
-            }
-        } else {
-            ++size;                           // Count regular character
-            ++ptr;
-        }
+    return microrl_config_set_complete_table(&mrl->cfg, table_ptr, table_len);
+}
+#endif /* (MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_TABLE) || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_CTRL_C || __DOXYGEN__
+/**
+ * \brief           Set callback for Ctrl+C terminal signal
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       sigint_fn: Ctrl+C terminal signal callback
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_set_sigint_callback(microrl_t* mrl, microrl_sigint_fn sigint_fn) {
+    if (mrl == NULL) {
+        return microrlERRPAR;
     }
 
-    return size;
+    return microrl_config_set_sigint_callback(&mrl->cfg, sigint_fn);
 }
-#endif
+#endif /* MICRORL_CFG_USE_CTRL_C || __DOXYGEN__ */
 
 /**
  * \brief           Set prompt string
@@ -913,19 +2304,30 @@ static size_t prv_calculate_prompt_size(const char* prompt_str) {
  * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
  */
 microrlr_t  microrl_set_prompt(microrl_t* mrl, char* prompt_str) {
-    if (mrl == NULL || prompt_str == NULL) {
+    if (mrl == NULL) {
         return microrlERRPAR;
     }
 
-    mrl->prompt_ptr = prompt_str;
-#if MICRORL_CFG_USE_PROMPT_COLOR
-    mrl->prompt_size = prv_calculate_prompt_size(prompt_str);
-#else
-    mrl->prompt_size = strlen(prompt_str);
-#endif
+    return microrl_config_set_prompt(&mrl->cfg, prompt_str);
+}
 
-    return microrlOK;
+#if MICRORL_CFG_USE_TIMING || __DOXYGEN__
+/**
+ * \brief           Set histograms to collect execution time of commands to
+ * \note            See \ref microrl_config_set_timing for array requirements
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       timing_arr: Zero-initialized array of histograms
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_set_timing(microrl_t* mrl, microrl_timing_t* timing_arr) {
+    if (mrl == NULL) {
+        return microrlERRPAR;
+    }
+
+    return microrl_config_set_timing(&mrl->cfg, timing_arr);
 }
+#endif /* MICRORL_CFG_USE_TIMING || __DOXYGEN__ */
+#endif /* !MICRORL_CFG_USE_SHARED_CONFIG || __DOXYGEN__ */
 
 #if MICRORL_CFG_USE_ECHO_OFF || __DOXYGEN__
 /**
@@ -959,10 +2361,24 @@ static microrlr_t prv_control_char_process(microrl_t* mrl, char ch) {
     switch (ch) {
         case MICRORL_ESC_ANSI_HT: {
 #if MICRORL_CFG_USE_COMPLETE
-            if (mrl->get_completion_fn == NULL) {
+#if !MICRORL_CFG_USE_EVENTS                     /* Completion is requested with event otherwise */
+            const microrl_config_t* cfg = MICRORL_CONFIG(mrl);
+#if MICRORL_CFG_USE_COMPLETE_TABLE
+            if ((cfg->get_completion_fn == NULL) && (cfg->get_compl_list_fn == NULL)
+                    && (cfg->compl_table_ptr == NULL)) {
+#else
+            if ((cfg->get_completion_fn == NULL) && (cfg->get_compl_list_fn == NULL)) {
+#endif /* MICRORL_CFG_USE_COMPLETE_TABLE */
                 return microrlERRPAR;
             }
-            if (prv_complete_get_input(mrl) != microrlOK) {
+#endif /* !MICRORL_CFG_USE_EVENTS */
+#if MICRORL_CFG_USE_COMPLETE_CYCLE
+            if (mrl->cycle_cnt != 0) {
+                prv_complete_cycle(mrl);
+                break;
+            }
+#endif /* MICRORL_CFG_USE_COMPLETE_CYCLE */
+            if (prv_complete_get_input(mrl, 1) != microrlOK) {
                 return microrlERRCPLT;
             }
 #endif /* MICRORL_CFG_USE_COMPLETE */
@@ -982,7 +2398,7 @@ static microrlr_t prv_control_char_process(microrl_t* mrl, char ch) {
             break;
         }
         case MICRORL_ESC_ANSI_VT: { /* ^K */
-            mrl->out_fn(mrl, "\033[K");
+            prv_terminal_write(mrl, "\033[K");
             mrl->cmdlen = mrl->cursor;
             break;
         }
@@ -1001,6 +2417,11 @@ static microrlr_t prv_control_char_process(microrl_t* mrl, char ch) {
                 prv_terminal_move_cursor(mrl, 1);
                 ++mrl->cursor;
             }
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+            else {
+                prv_hint_accept(mrl);
+            }
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
             break;
         }
         case MICRORL_ESC_ANSI_STX: { /* ^B */
@@ -1040,17 +2461,28 @@ static microrlr_t prv_control_char_process(microrl_t* mrl, char ch) {
             break;
         }
         case MICRORL_ESC_ANSI_DC2: { /* ^R */
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+            prv_hint_erase(mrl);
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
             prv_terminal_newline(mrl);
+#if MICRORL_CFG_USE_COMPLETE
+            prv_complete_erase_list(mrl);
+#endif /* MICRORL_CFG_USE_COMPLETE */
             prv_terminal_print_prompt(mrl);
             prv_terminal_print_line(mrl, 0, 0);
             break;
         }
         case MICRORL_ESC_ANSI_ETX: {
 #if MICRORL_CFG_USE_CTRL_C
-            if (mrl->sigint_fn == NULL) {
+            if (MICRORL_CONFIG(mrl)->sigint_fn == NULL) {
+#if MICRORL_CFG_USE_EVENTS
+                mrl->evt_sigint = 1;
+                break;
+#else
                 return microrlERRPAR;
+#endif /* MICRORL_CFG_USE_EVENTS */
             }
-            mrl->sigint_fn(mrl);
+            MICRORL_CONFIG(mrl)->sigint_fn(mrl);
 #endif /* MICRORL_CFG_USE_CTRL_C */
             break;
         }
@@ -1079,11 +2511,11 @@ static microrlr_t prv_insert_char(microrl_t* mrl, char ch) {
         char nch[] = {0, 0};
         nch[0] = ch;
 #if MICRORL_CFG_USE_ECHO_OFF
-        if (((int32_t)mrl->cursor >= mrl->echo_off_pos) && (mrl->echo != MICRORL_ECHO_ON)) {
+        if (prv_echo_is_masked(mrl, mrl->cursor)) {
             nch[0] = MICRORL_CFG_ECHO_OFF_MASK;
         }
 #endif /* MICRORL_CFG_USE_ECHO_OFF */
-        mrl->out_fn(mrl, nch);
+        prv_terminal_write(mrl, nch);
     } else {
         prv_terminal_print_line(mrl, mrl->cursor - 1, 0);
     }
@@ -1092,26 +2524,63 @@ static microrlr_t prv_insert_char(microrl_t* mrl, char ch) {
 }
 
 /**
- * \brief           Processing command line input
- * \param[in]       mrl: \ref microrl_t working instance
- * \param[in]       data_ptr: Input data to process
- * \param[in]       len: Length of data for input
- * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ * \brief           Process input characters one by one
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       buf_ptr: Input characters
+ * \param[in]       len: Number of characters
+ * \return          \ref microrlOK on success, the last error of processing otherwise
  */
-microrlr_t microrl_processing_input(microrl_t* mrl, const void* data_ptr, size_t len) {
-    if (mrl == NULL || data_ptr == NULL || len == 0) {
-        return microrlERRPAR;
-    }
-
-    char* buf_ptr = (char*)data_ptr;
+static microrlr_t prv_input_process(microrl_t* mrl, const char* buf_ptr, size_t len) {
+    microrlr_t last_res = microrlOK;
 
+    /* Errors don't stop processing, rest of input is handled the same way as if it came byte by byte */
     while (len-- != 0) {
         char ch = *buf_ptr++;
 
+#if MICRORL_CFG_USE_DEFERRED_EXEC
+        if (mrl->exec_pending) {
+#if MICRORL_CFG_USE_CTRL_C
+            if (ch == MICRORL_ESC_ANSI_ETX) {   /* Ctrl+C is passed at once to be able to abort the command */
+                if (MICRORL_CONFIG(mrl)->sigint_fn != NULL) {
+                    MICRORL_CONFIG(mrl)->sigint_fn(mrl);
+                }
+#if MICRORL_CFG_USE_EVENTS
+                else {
+                    mrl->evt_sigint = 1;
+                }
+#endif /* MICRORL_CFG_USE_EVENTS */
+                continue;
+            }
+#endif /* MICRORL_CFG_USE_CTRL_C */
+            if (mrl->typeahead_len < MICRORL_ARRAYSIZE(mrl->typeahead_str)) {
+                mrl->typeahead_str[mrl->typeahead_len++] = ch;
+            } else {
+                last_res = microrlERRCLFULL;
+            }
+            continue;
+        }
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC */
+
+#if MICRORL_CFG_USE_COMPLETE && (MICRORL_CFG_COMPL_QUERY_ITEMS > 0)
+        if (mrl->compl_query) {
+            prv_complete_query_answer(mrl, ch);
+            continue;
+        }
+#endif /* MICRORL_CFG_USE_COMPLETE && (MICRORL_CFG_COMPL_QUERY_ITEMS > 0) */
+
+#if MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_CYCLE
+        if (ch != MICRORL_ESC_ANSI_HT) {
+            mrl->cycle_cnt = 0;                 /* Any key except 'Tab' stops cycling */
+        }
+#endif /* MICRORL_CFG_USE_COMPLETE && MICRORL_CFG_USE_COMPLETE_CYCLE */
+
 #if MICRORL_CFG_USE_ESC_SEQ
         if (mrl->escape) {
             if (prv_escape_process(mrl, ch)) {
                 mrl->escape = 0;
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+                prv_hint_update(mrl);
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
             }
             continue;
         }
@@ -1127,7 +2596,7 @@ microrlr_t microrl_processing_input(microrl_t* mrl, const void* data_ptr, size_t
             } else {
                 mrl->last_endl = ch;
                 if (prv_handle_newline(mrl) != microrlOK) {
-                    return microrlERRTKNNUM;
+                    last_res = microrlERRTKNNUM;
                 }
             }
             continue;
@@ -1139,18 +2608,449 @@ microrlr_t microrl_processing_input(microrl_t* mrl, const void* data_ptr, size_t
             res = prv_control_char_process(mrl, ch);
         } else {
             if ((ch == ' ') && (mrl->cmdlen == 0)) {    /* Skip spaces before first command line symbol */
-                break;
+                continue;
             }
             res = prv_insert_char(mrl, ch);
         }
         if (res != microrlOK) {
-            return res;
+            last_res = res;
+            continue;
+        }
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+        prv_hint_update(mrl);
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
+    }
+
+    return last_res;
+}
+
+/**
+ * \brief           Processing command line input
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[in]       data_ptr: Input data to process
+ * \param[in]       len: Length of data for input
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_processing_input(microrl_t* mrl, const void* data_ptr, size_t len) {
+    if (mrl == NULL || data_ptr == NULL || len == 0) {
+        return microrlERRPAR;
+    }
+
+    MICRORL_STATS_ADD(mrl, in_bytes, len);
+    return prv_input_process(mrl, data_ptr, len);
+}
+
+#if MICRORL_CFG_USE_INPUT_RING || __DOXYGEN__
+
+/**
+ * \brief           Initialize input ring buffer
+ * \param[out]      ring: Input ring buffer to initialize
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_input_ring_init(microrl_input_ring_t* ring) {
+    if (ring == NULL) {
+        return microrlERRPAR;
+    }
+
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overflow_cnt = 0;
+
+    return microrlOK;
+}
+
+/**
+ * \brief           Push received characters into input ring buffer.
+ *                      Safe to call from interrupt handler, while main loop drains the ring
+ * \note            Only one producer is allowed, don't call it from different interrupts
+ *                      without masking them
+ * \param[in,out]   ring: Input ring buffer
+ * \param[in]       data_ptr: Received characters
+ * \param[in]       len: Number of received characters
+ * \return          Number of characters pushed, the rest is dropped and added to `overflow_cnt`
+ */
+size_t microrl_input_ring_push(microrl_input_ring_t* ring, const void* data_ptr, size_t len) {
+    if (ring == NULL || data_ptr == NULL) {
+        return 0;
+    }
+
+    const char* buf_ptr = (const char*)data_ptr;
+    microrl_ring_idx_t head = ring->head;
+    size_t free_len = MICRORL_CFG_INPUT_RING_LEN - (microrl_ring_idx_t)(head - ring->tail);
+    size_t push_len = len < free_len ? len : free_len;
+
+    MICRORL_CFG_INPUT_RING_BARRIER();           /* Don't overwrite characters before consumer released them */
+    for (size_t i = 0; i < push_len; ++i) {
+        ring->buf[(microrl_ring_idx_t)(head + i) & (MICRORL_CFG_INPUT_RING_LEN - 1)] = buf_ptr[i];
+    }
+    MICRORL_CFG_INPUT_RING_BARRIER();           /* Publish characters before moving head */
+    ring->head = (microrl_ring_idx_t)(head + push_len);
+
+    if (push_len < len) {
+        ring->overflow_cnt += (uint16_t)(len - push_len);
+    }
+
+    return push_len;
+}
+
+/**
+ * \brief           Pass all characters from input ring buffer to the instance.
+ *                      Call it from main loop, characters are processed in place without copying
+ * \note            Characters received while command is executed stay in the ring until next call,
+ *                      so ring must be large enough to hold them
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in,out]   ring: Input ring buffer filled by producer
+ * \return          \ref microrlOK on success or if ring is empty,
+ *                      last error of \ref microrl_processing_input otherwise
+ */
+microrlr_t microrl_input_ring_drain(microrl_t* mrl, microrl_input_ring_t* ring) {
+    if (mrl == NULL || ring == NULL) {
+        return microrlERRPAR;
+    }
+
+    microrlr_t res = microrlOK;
+    microrl_ring_idx_t tail = ring->tail;
+    size_t len = (microrl_ring_idx_t)(ring->head - tail);
+
+    if (len == 0) {
+        return microrlOK;
+    }
+    MICRORL_CFG_INPUT_RING_BARRIER();           /* Read characters only after head is read */
+
+    /* Characters may wrap around the buffer end, process them in two contiguous parts */
+    size_t pos = tail & (MICRORL_CFG_INPUT_RING_LEN - 1);
+    size_t part_len = MICRORL_CFG_INPUT_RING_LEN - pos;
+    if (part_len > len) {
+        part_len = len;
+    }
+    res = microrl_processing_input(mrl, &ring->buf[pos], part_len);
+    if (part_len < len) {
+        microrlr_t part_res = microrl_processing_input(mrl, ring->buf, len - part_len);
+        if (part_res != microrlOK) {
+            res = part_res;
+        }
+    }
+
+    MICRORL_CFG_INPUT_RING_BARRIER();           /* Release characters only after they are processed */
+    ring->tail = (microrl_ring_idx_t)(tail + len);
+
+    return res;
+}
+
+#endif /* MICRORL_CFG_USE_INPUT_RING || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__
+
+/**
+ * \brief           Process input typed ahead while command was executed
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+static microrlr_t prv_typeahead_process(microrl_t* mrl) {
+    size_t len = mrl->typeahead_len;
+
+    if (len == 0) {
+        return microrlOK;
+    }
+
+    /*
+     * Characters are read before they are typed ahead again, if the next command is deferred too,
+     * so the rest of input is safely moved to the beginning of the same buffer
+     */
+    mrl->typeahead_len = 0;
+    return prv_input_process(mrl, mrl->typeahead_str, len);     /* Input is counted when it is received */
+}
+
+/**
+ * \brief           Finish command, for which execute callback returned \ref MICRORL_EXEC_PENDING.
+ *                      Post command hook is called with tokens of line polled as \ref MICRORL_EVENT_LINE,
+ *                      or with no arguments if the line was passed to execute callback, then prompt
+ *                      is printed and input typed ahead meanwhile is processed
+ * \note            Call it in the same context as \ref microrl_processing_input,
+ *                      e.g. from main loop when the task executing command is done
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       status: Result of the command, passed to post command hook
+ * \return          \ref microrlOK on success, \ref microrlERR if no command is pending,
+ *                      error of processing typed ahead input otherwise
+ */
+microrlr_t microrl_command_complete(microrl_t* mrl, int status) {
+#if MICRORL_CFG_USE_COMMAND_HOOKS
+    static const char* const empty_argv[1] = {NULL};
+    const char* const* argv = empty_argv;
+    int argc = 0;
+#endif /* MICRORL_CFG_USE_COMMAND_HOOKS */
+
+    if (mrl == NULL) {
+        return microrlERRPAR;
+    }
+    if (!mrl->exec_pending) {
+        return microrlERR;
+    }
+#if MICRORL_CFG_USE_EVENTS
+    if (mrl->evt_type == MICRORL_EVENT_COMPLETE) {
+        return microrlERR;                      /* Completion is finished with microrl_complete_answer() */
+    }
+#if MICRORL_CFG_USE_COMMAND_HOOKS
+    if (mrl->evt_type == MICRORL_EVENT_LINE) {
+        argc = mrl->evt_argc;                   /* Tokens of event are still in the kept line */
+        argv = mrl->evt_argv;
+    }
+#endif /* MICRORL_CFG_USE_COMMAND_HOOKS */
+#endif /* MICRORL_CFG_USE_EVENTS */
+
+    mrl->exec_pending = 0;
+#if MICRORL_CFG_USE_TIMING
+    prv_timing_stop(mrl);
+#endif /* MICRORL_CFG_USE_TIMING */
+    MICRORL_UNUSED(status);                     /* Status is used only by post command hook */
+#if MICRORL_CFG_USE_COMMAND_HOOKS
+    MICRORL_UNUSED(argc);                       /* Arguments are used only by post command hook */
+    MICRORL_UNUSED(argv);
+    MICRORL_POST_COMMAND_HOOK(mrl, status, argc, argv);
+#endif /* MICRORL_CFG_USE_COMMAND_HOOKS */
+#if MICRORL_CFG_USE_EVENTS
+    if (mrl->evt_type == MICRORL_EVENT_LINE) {
+        prv_cmdline_buf_reset(mrl);             /* Line was kept for arguments of event and hook */
+    }
+    mrl->evt_type = MICRORL_EVENT_NONE;
+#endif /* MICRORL_CFG_USE_EVENTS */
+    prv_terminal_print_prompt(mrl);
+
+    return prv_typeahead_process(mrl);
+}
+
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_EVENTS || __DOXYGEN__
+
+/**
+ * \brief           Get the next event raised by \ref microrl_processing_input
+ *
+ * Events are raised instead of calling callbacks set to NULL. After \ref MICRORL_EVENT_LINE
+ * or \ref MICRORL_EVENT_COMPLETE is raised, input is typed ahead without echo until the line is
+ * finished with \ref microrl_command_complete or completion is answered with \ref microrl_complete_answer.
+ * Arguments of event point to command line buffer of instance and stay valid until then.
+ *
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[out]      evt_ptr: Event to fill
+ * \return          \ref microrlOK if event is polled, \ref microrlERREMPTY if there are no new events,
+ *                      member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_poll_event(microrl_t* mrl, microrl_event_t* evt_ptr) {
+    if (mrl == NULL || evt_ptr == NULL) {
+        return microrlERRPAR;
+    }
+
+    evt_ptr->argc = 0;
+    evt_ptr->argv = NULL;
+    if (mrl->evt_sigint) {                      /* Ctrl+C goes first, it may abort running command */
+        mrl->evt_sigint = 0;
+        evt_ptr->type = MICRORL_EVENT_SIGINT;
+        return microrlOK;
+    }
+    if ((mrl->evt_type != MICRORL_EVENT_NONE) && !mrl->evt_polled) {
+        mrl->evt_polled = 1;
+        evt_ptr->type = (microrl_event_type_t)mrl->evt_type;
+        evt_ptr->argc = mrl->evt_argc;
+        evt_ptr->argv = mrl->evt_argv;
+        return microrlOK;
+    }
+    evt_ptr->type = MICRORL_EVENT_NONE;
+
+    return microrlERREMPTY;
+}
+
+#if MICRORL_CFG_USE_COMPLETE || __DOXYGEN__
+/**
+ * \brief           Answer \ref MICRORL_EVENT_COMPLETE with completion candidates.
+ *                      Then input typed ahead meanwhile is processed
+ *
+ * The list is read during the call only, so it may be temporary, while candidates array, lengths
+ * and strings it points to must stay valid until the call returns. With \ref MICRORL_CFG_USE_COMPLETE_CYCLE
+ * candidates are cached for the next 'Tab', so they must stay valid until a key other than 'Tab' is processed.
+ *
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       cmplt_list_ptr: Completion candidates, the same as filled by
+ *                      \ref microrl_get_compl_list_fn callback, or NULL if there are no candidates
+ * \return          \ref microrlOK on success, \ref microrlERR if completion isn't requested,
+ *                      member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_complete_answer(microrl_t* mrl, const microrl_compl_list_t* cmplt_list_ptr) {
+    static const microrl_compl_list_t empty_list = {NULL, NULL, 0, MICRORL_COMPL_PREFIX_UNKNOWN};
+
+    if (mrl == NULL) {
+        return microrlERRPAR;
+    }
+    if (mrl->evt_type != MICRORL_EVENT_COMPLETE) {
+        return microrlERR;
+    }
+
+    mrl->evt_type = MICRORL_EVENT_NONE;
+    mrl->exec_pending = 0;
+    microrlr_t res = prv_complete_apply(mrl, cmplt_list_ptr != NULL ? cmplt_list_ptr : &empty_list,
+                                        mrl->evt_tkn_end, strlen(mrl->evt_argv[mrl->evt_argc - 1]),
+                                        mrl->evt_query);
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+    prv_hint_update(mrl);
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
+
+    microrlr_t typeahead_res = prv_typeahead_process(mrl);
+    return res != microrlOK ? res : typeahead_res;
+}
+#endif /* MICRORL_CFG_USE_COMPLETE || __DOXYGEN__ */
+
+#endif /* MICRORL_CFG_USE_EVENTS || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__
+
+/**
+ * \brief           Queue message to print above the prompt on the next \ref microrl_service call.
+ *                      Safe to call from any thread or interrupt, while instance is used by main loop
+ * \note            Message is printed as a separate line, \ref MICRORL_CFG_END_LINE is added to it.
+ *                      Messages longer than \ref MICRORL_CFG_ASYNC_PRINT_MSG_LEN are truncated
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \param[in]       str: Message to print
+ * \return          \ref microrlOK on success, \ref microrlERR if queue is full and message is dropped,
+ *                      member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_print_async(microrl_t* mrl, const char* str) {
+    if (mrl == NULL || str == NULL) {
+        return microrlERRPAR;
+    }
+
+    microrl_async_queue_t* queue_ptr = &mrl->async_queue;
+    microrl_async_msg_t* msg_ptr;
+    uint8_t pos = MICRORL_CFG_ASYNC_PRINT_LOAD(&queue_ptr->enq_pos);
+
+    for (;;) {
+        msg_ptr = &queue_ptr->msg_arr[pos & (MICRORL_CFG_ASYNC_PRINT_MSG_NUM - 1)];
+        int8_t diff = (int8_t)(uint8_t)(MICRORL_CFG_ASYNC_PRINT_LOAD(&msg_ptr->seq) - pos);
+
+        if (diff == 0) {                        /* Message is free, try to reserve it */
+            if (MICRORL_CFG_ASYNC_PRINT_CAS(&queue_ptr->enq_pos, &pos, (uint8_t)(pos + 1))) {
+                break;
+            }                                   /* Otherwise 'pos' is updated to reserve the next one */
+        } else if (diff < 0) {                  /* Message wasn't printed yet */
+            return microrlERR;
+        } else {                                /* Message is reserved by another producer */
+            pos = MICRORL_CFG_ASYNC_PRINT_LOAD(&queue_ptr->enq_pos);
+        }
+    }
+
+    size_t len = 0;
+    while ((len < MICRORL_CFG_ASYNC_PRINT_MSG_LEN) && (str[len] != '\0')) {
+        msg_ptr->msg_str[len] = str[len];
+        ++len;
+    }
+    memcpy(&msg_ptr->msg_str[len], MICRORL_CFG_END_LINE, sizeof(MICRORL_CFG_END_LINE));
+    MICRORL_CFG_ASYNC_PRINT_STORE(&msg_ptr->seq, (uint8_t)(pos + 1));  /* Publish message */
+
+    return microrlOK;
+}
+
+/**
+ * \brief           Print queued asynchronous messages above the prompt.
+ *                      Command line is erased, all messages are printed at once,
+ *                      then prompt and command line are redrawn only once
+ * \note            Call it from main loop, in the same context as \ref microrl_processing_input,
+ *                      but not from the library callbacks
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_service(microrl_t* mrl) {
+    if (mrl == NULL) {
+        return microrlERRPAR;
+    }
+
+#if MICRORL_CFG_USE_COMPLETE && (MICRORL_CFG_COMPL_QUERY_ITEMS > 0)
+    if (mrl->compl_query) {
+        return microrlOK;                       /* Keep messages until completion question is answered */
+    }
+#endif /* MICRORL_CFG_USE_COMPLETE && (MICRORL_CFG_COMPL_QUERY_ITEMS > 0) */
+#if MICRORL_CFG_USE_EVENTS
+    if (mrl->evt_type == MICRORL_EVENT_COMPLETE) {
+        return microrlOK;                       /* Command line is split for arguments until answer */
+    }
+#endif /* MICRORL_CFG_USE_EVENTS */
+
+    microrl_async_queue_t* queue_ptr = &mrl->async_queue;
+    uint8_t pos = queue_ptr->deq_pos;
+    size_t cnt = 0;
+    uint8_t redraw = 1;
+
+#if MICRORL_CFG_USE_DEFERRED_EXEC
+    redraw = !mrl->exec_pending;                /* No prompt while command is executed, print after its output */
+#endif /* MICRORL_CFG_USE_DEFERRED_EXEC */
+
+    /* Messages queued while printing are left to the next call, so it never takes longer than a full queue */
+    for (; cnt < MICRORL_CFG_ASYNC_PRINT_MSG_NUM; ++cnt, ++pos) {
+        microrl_async_msg_t* msg_ptr = &queue_ptr->msg_arr[pos & (MICRORL_CFG_ASYNC_PRINT_MSG_NUM - 1)];
+
+        if (MICRORL_CFG_ASYNC_PRINT_LOAD(&msg_ptr->seq) != (uint8_t)(pos + 1)) {
+            break;                              /* No more published messages */
         }
+        if ((cnt == 0) && redraw) {             /* Erase prompt, command line and all below it */
+            char str[24] = {0};
+            char* str_ptr = prv_cursor_generate_line_pos(mrl, str, -(int32_t)MICRORL_CONFIG(mrl)->prompt_size);
+            strcpy(str_ptr, "\033[J");
+            prv_terminal_write(mrl, str);
+#if MICRORL_CFG_USE_COMPLETE
+            mrl->compl_list_shown = 0;
+#endif /* MICRORL_CFG_USE_COMPLETE */
+        }
+        prv_terminal_write(mrl, msg_ptr->msg_str);
+        MICRORL_CFG_ASYNC_PRINT_STORE(&msg_ptr->seq, (uint8_t)(pos + MICRORL_CFG_ASYNC_PRINT_MSG_NUM));
+    }
+    queue_ptr->deq_pos = pos;
+
+    if ((cnt != 0) && redraw) {
+        prv_terminal_print_prompt(mrl);
+        prv_terminal_print_line(mrl, 0, 0);
+#if MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS
+        prv_hint_update(mrl);
+#endif /* MICRORL_CFG_USE_HISTORY && MICRORL_CFG_USE_HISTORY_HINTS */
+    }
+
+    return microrlOK;
+}
+
+#endif /* MICRORL_CFG_USE_ASYNC_PRINT || __DOXYGEN__ */
+
+#if MICRORL_CFG_USE_STATS || __DOXYGEN__
+
+/**
+ * \brief           Get counters of instance
+ * \param[in]       mrl: \ref microrl_t working instance
+ * \param[out]      stats_ptr: Pointer to structure to copy counters to
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_get_stats(const microrl_t* mrl, microrl_stats_t* stats_ptr) {
+    if (mrl == NULL || stats_ptr == NULL) {
+        return microrlERRPAR;
+    }
+
+    *stats_ptr = mrl->stats;
+
+    return microrlOK;
+}
+
+/**
+ * \brief           Reset counters of instance to zero, e.g. after they are exported
+ * \param[in,out]   mrl: \ref microrl_t working instance
+ * \return          \ref microrlOK on success, member of \ref microrlr_t enumeration otherwise
+ */
+microrlr_t microrl_reset_stats(microrl_t* mrl) {
+    if (mrl == NULL) {
+        return microrlERRPAR;
     }
 
+    memset(&mrl->stats, 0x00, sizeof(mrl->stats));
+
     return microrlOK;
 }
 
+#endif /* MICRORL_CFG_USE_STATS || __DOXYGEN__ */
+
 /**
  * \brief           Get current version number of the MicroRL library.
  *                      Semantic versioning is used for numbering
@@ -1175,8 +3075,8 @@ microrlr_t  microrl_clear_terminal(microrl_t* mrl){
         return microrlERRPAR;
     }
 
-    mrl->out_fn(mrl, "\033[2J");        /* Clear screen */
-    mrl->out_fn(mrl, "\033[H");         /* Move cursor to home position */
+    prv_terminal_write(mrl, "\033[2J");        /* Clear screen */
+    prv_terminal_write(mrl, "\033[H");         /* Move cursor to home position */
     prv_terminal_print_prompt(mrl);
     prv_terminal_print_line(mrl, 0, 0);
 
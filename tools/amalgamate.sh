@@ -0,0 +1,72 @@
+#!/bin/sh
+#
+# Amalgamate microrl_config.h, microrl.h and microrl.c into single header microrl_single.h.
+# Declarations are available wherever the header is included, the library is compiled
+# in the file defining MICRORL_IMPLEMENTATION before including it.
+#
+# Usage: amalgamate.sh [output]
+#   output     file to write, standard output by default
+#
+# This file is part of MicroRL - Micro Read Line library for small and embedded devices.
+#
+
+ROOT=$(dirname "$0")/..
+INC=$ROOT/src/include/microrl
+SRC=$ROOT/src/microrl
+
+for f in "$INC/microrl_config.h" "$INC/microrl.h" "$SRC/microrl.c"; do
+    if [ ! -f "$f" ]; then
+        echo "$0: $f not found" >&2
+        exit 1
+    fi
+done
+VERSION=$(sed -n 's/^ \* Version: *//p' "$SRC/microrl.c")
+
+# Sources of the library include each other by these lines only, user configuration is kept
+strip_includes() {
+    sed -e '/^#include "microrl_config.h"$/d' -e '/^#include "microrl.h"$/d' "$1"
+}
+
+amalgamate() {
+    cat << EOF
+/**
+ * \\file            microrl_single.h
+ * \\brief           Micro Read Line library, single header build
+ *
+ * Generated by tools/amalgamate.sh from microrl_config.h, microrl.h and microrl.c
+ * of version $VERSION, don't edit it.
+ *
+ * Include the header for declarations. In exactly one C file define MICRORL_IMPLEMENTATION
+ * before including it, to compile the library in that file:
+ *
+ *     #define MICRORL_IMPLEMENTATION
+ *     #include "microrl_single.h"
+ *
+ * Then compiler sees the library with its caller, so input processing may be inlined into it,
+ * and output function set by MICRORL_CFG_OUT_FN, declared before the implementation,
+ * is inlined into the library. Configuration is read from microrl_user_config.h as usual,
+ * every file must be built with the same one.
+ */
+
+EOF
+    strip_includes "$INC/microrl_config.h"
+    echo
+    strip_includes "$INC/microrl.h"
+    cat << 'EOF'
+
+#if defined(MICRORL_IMPLEMENTATION) && !defined(MICRORL_IMPLEMENTATION_DONE)
+#define MICRORL_IMPLEMENTATION_DONE
+
+EOF
+    strip_includes "$SRC/microrl.c"
+    cat << 'EOF'
+
+#endif /* defined(MICRORL_IMPLEMENTATION) && !defined(MICRORL_IMPLEMENTATION_DONE) */
+EOF
+}
+
+if [ $# -gt 0 ]; then
+    amalgamate > "$1.tmp" && mv "$1.tmp" "$1"
+else
+    amalgamate
+fi